@@ -0,0 +1,272 @@
+/*
+ * analysis.c : fleet-wide comparison of snapshot files
+ *
+ * The latest record of every snapshot file is taken as the state of one unit.
+ * For each register the values of all the units are gathered into a
+ * histogram; the most frequent value is the majority, and when only a few
+ * units disagree with it (at most a given percentage) they are reported as
+ * outliers. Registers on which the units disagree widely, counters or
+ * statuses, are not reported.
+ *
+ * The files are mapped, nothing is copied. The registers are handed out in
+ * small chunks to a pool of threads, each one working on its own registers
+ * over all the files with no locking but the chunk counter, so the analysis
+ * scales with the number of cores.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <endian.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "devicedbg.h"
+
+#define AN_CHUNK	16	/* registers taken by a thread at a time */
+
+struct an_unit {
+	char *path;
+	const struct dd_snap_hdr *hdr;
+	size_t size;
+	const uint8_t *values;		/* latest record */
+};
+
+struct an_result {
+	uint32_t majority;		/* most frequent value */
+	uint32_t count;			/* units holding it */
+	uint32_t distinct;		/* distinct values */
+};
+
+static struct an_unit *units;
+static int num_units, units_size;
+static struct an_result *results;
+static int num_regs;
+static int next_reg;			/* next chunk, taken atomically */
+
+static void unit_add(const char *path) {
+	if(num_units == units_size) {
+		units_size = units_size ? 2 * units_size : 256;
+		if((units = realloc(units, units_size * sizeof(struct an_unit))) == NULL) FATAL;
+	}
+
+	memset(&units[num_units], 0, sizeof(struct an_unit));
+	if((units[num_units++].path = strdup(path)) == NULL) FATAL;
+}
+
+/* A directory stands for all the snapshot files it holds */
+static void units_collect(const char *path) {
+	char name[4096];
+	struct dirent *de;
+	struct stat st;
+	size_t len;
+	DIR *dir;
+
+	if(stat(path, &st) == -1 || !S_ISDIR(st.st_mode)) {
+		unit_add(path);
+		return;
+	}
+
+	if((dir = opendir(path)) == NULL) {
+		fprintf(stderr, "devicedbg: %s: %s\n", path, strerror(errno));
+		return;
+	}
+
+	while((de = readdir(dir)) != NULL) {
+		len = strlen(de->d_name);
+		if(len > 5 && strcmp(de->d_name + len - 5, ".snap") == 0) {
+			snprintf(name, sizeof(name), "%s/%s", path, de->d_name);
+			unit_add(name);
+		}
+	}
+
+	closedir(dir);
+}
+
+static int unit_cmp(const void *a, const void *b) {
+	return strcmp(((const struct an_unit *) a)->path, ((const struct an_unit *) b)->path);
+}
+
+static int value_cmp(const void *a, const void *b) {
+	uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+
+	return x < y ? -1 : x > y;
+}
+
+/* Histogram of one register over all the units, kept as its majority */
+static void analyze_register(int r, uint32_t *values) {
+	struct an_result *res = &results[r];
+	uint32_t run = 0;
+	int u;
+
+	for(u = 0; u < num_units; u++)
+		values[u] = le32toh(*(const uint32_t *) (units[u].values + 4 * r));
+
+	qsort(values, num_units, sizeof(uint32_t), value_cmp);
+
+	for(u = 0; u < num_units; u++) {
+		if(u > 0 && values[u] == values[u - 1]) {
+			run++;
+		}
+		else {
+			run = 1;
+			res->distinct++;
+		}
+
+		if(run > res->count) {
+			res->count = run;
+			res->majority = values[u];
+		}
+	}
+}
+
+static void *analysis_worker(void *arg) {
+	uint32_t *values;
+	int r, first;
+
+	if((values = malloc(num_units * sizeof(uint32_t))) == NULL) FATAL;
+
+	while((first = __atomic_fetch_add(&next_reg, AN_CHUNK, __ATOMIC_RELAXED)) < num_regs) {
+		for(r = first; r < first + AN_CHUNK && r < num_regs; r++)
+			analyze_register(r, values);
+	}
+
+	free(values);
+	return NULL;
+}
+
+/* Maps the units and keeps the ones matching the layout of the first one
+ * Output:
+ *	registry of that layout, or -1 if there is nothing to analyze
+ */
+static int units_map(struct reg_registry *rr) {
+	const struct soc_family *family = NULL;
+	int i, n = 0;
+
+	for(i = 0; i < num_units; i++) {
+		struct an_unit *u = &units[i];
+
+		if((u->hdr = snap_map(u->path, &u->size)) == NULL) {
+			fprintf(stderr, "devicedbg: %s: %s\n", u->path, strerror(errno));
+			goto skip;
+		}
+
+		if(family == NULL) {
+			if((family = find_family_type(le16toh(u->hdr->type))) == NULL ||
+			   registry_build(rr, family) == -1 || rr->hash != le32toh(u->hdr->hash)) {
+				fprintf(stderr, "devicedbg: %s does not match the register tables\n", u->path);
+				return -1;
+			}
+		}
+
+		if(le32toh(u->hdr->hash) != rr->hash || le32toh(u->hdr->count) != rr->count) {
+			fprintf(stderr, "devicedbg: %s: other register layout, skipped\n", u->path);
+			goto skip;
+		}
+
+		if(snap_records(u->hdr, u->size) == 0)
+			goto skip;
+
+		u->values = snap_values(u->hdr, snap_records(u->hdr, u->size) - 1);
+		units[n++] = *u;
+		continue;
+
+	skip:
+		if(u->hdr != NULL)
+			munmap((void *) u->hdr, u->size);
+		free(u->path);
+	}
+
+	num_units = n;
+	return n > 0 ? 0 : -1;
+}
+
+/*
+ * Compares the latest snapshot of many units and reports the outliers
+ * Input:
+ *	int threads		- worker threads, the online processors if 0
+ *	int percent		- most units that may disagree with the majority
+ *				  for the disagreeing ones to be outliers
+ *	int argc, char **argv	- snapshot files or directories of them
+ *
+ * Output:
+ *	exit status of the program, 2 if any outlier was found
+ */
+int run_analysis(int threads, int percent, int argc, char **argv) {
+	struct reg_registry rr;
+	pthread_t *pool;
+	char qname[REG_NAME_LEN];
+	uint64_t start;
+	int i, r, u, differ = 0, outliers = 0;
+
+	for(i = 0; i < argc; i++)
+		units_collect(argv[i]);
+	qsort(units, num_units, sizeof(struct an_unit), unit_cmp);
+
+	memset(&rr, 0, sizeof(rr));
+	if(num_units == 0 || units_map(&rr) == -1) {
+		fprintf(stderr, "devicedbg: no snapshot to analyze\n");
+		return 1;
+	}
+
+	if(threads <= 0)
+		threads = sysconf(_SC_NPROCESSORS_ONLN);
+	if(threads <= 0)
+		threads = 1;
+
+	num_regs = rr.count;
+	if((results = calloc(num_regs, sizeof(struct an_result))) == NULL) FATAL;
+	if((pool = malloc(threads * sizeof(pthread_t))) == NULL) FATAL;
+
+	start = now_ns();
+	for(i = 0; i < threads; i++) {
+		if(pthread_create(&pool[i], NULL, analysis_worker, NULL) != 0) FATAL;
+	}
+	for(i = 0; i < threads; i++)
+		pthread_join(pool[i], NULL);
+
+	fprintf(stderr, "%d units x %d registers analyzed in %.1f ms with %d threads\n",
+		num_units, num_regs, (now_ns() - start) / 1e6, threads);
+
+	for(r = 0; r < num_regs; r++) {
+		const struct an_result *res = &results[r];
+
+		if(res->distinct == 1)
+			continue;
+		differ++;
+
+		if((uint64_t) (num_units - res->count) * 100 > (uint64_t) percent * num_units)
+			continue;
+		outliers++;
+
+		printf("%-32s 0x%08lX: 0x%08X on %u/%d units, %u distinct values\n",
+		       reg_entry_name(&rr.entries[r], qname), rr.entries[r].addr, res->majority,
+		       res->count, num_units, res->distinct);
+
+		for(u = 0; u < num_units; u++) {
+			uint32_t v = le32toh(*(const uint32_t *) (units[u].values + 4 * r));
+
+			if(v != res->majority)
+				printf("\t%-40s 0x%08X\n", units[u].path, v);
+		}
+	}
+
+	printf("%d registers differ between units, %d with outliers (at most %d%% of the units)\n",
+	       differ, outliers, percent);
+
+	for(u = 0; u < num_units; u++) {
+		munmap((void *) units[u].hdr, units[u].size);
+		free(units[u].path);
+	}
+	free(units);
+	free(results);
+	free(pool);
+	registry_free(&rr);
+
+	return outliers > 0 ? 2 : 0;
+}
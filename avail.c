@@ -0,0 +1,262 @@
+/*
+ * avail.c : availability of the modules, probed once per boot
+ *
+ * A module whose clocks are gated (CONFIG_OMAP_RESET_CLOCKS, or no driver
+ * enabled it) answers any access with a bus error. The accesses to the
+ * registers are guarded (mem_guard()): a fault marks the module, every
+ * register of its instance, absent in the registry, and the plans stop
+ * reading it.
+ *
+ * At startup the first register of every instance is read once (the first
+ * without side effects on read, the receive FIFO of a UART is at 0), and the
+ * absent modules are saved in AVAIL_FILE with the boot they were probed in
+ * (BOOT_ID_FILE) and the memory file, one instance name per line:
+ *
+ *	# devicedbg module availability
+ *	# boot 5f1c2a8e-9d3b-4a51-8b07-2e4c6f0d9a13
+ *	# memory /dev/mem
+ *	MCASP1
+ *
+ * Later runs of the same boot take the list from there without touching the
+ * modules again. Faults found afterwards are appended to it. The list lives
+ * in /run, writable by root only, and is ignored unless it is a regular file
+ * of the user running devicedbg that no one else can write.
+ *
+ * Whether a module is clocked changes with the drivers, it is not kept: the
+ * module state register of an instance (struct reg_instance) is read before
+ * the module, once per run of a plan. The probe skips the modules it shows
+ * off, only the modules it does not know about or gets wrong can fault.
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include <string.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include "devicedbg.h"
+
+#define AVAIL_HEADER	"# devicedbg module availability\n"
+
+static pthread_mutex_t avail_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void avail_path(const struct reg_registry *rr, char *path, size_t size) {
+	snprintf(path, size, AVAIL_FILE, rr->family->name, rr->hash);
+}
+
+/* Identifier of the running boot, -1 if the kernel does not give one */
+static int avail_boot(char *boot, size_t size) {
+	FILE *f;
+	int ret = -1;
+
+	if((f = fopen(BOOT_ID_FILE, "r")) == NULL)
+		return -1;
+
+	if(fgets(boot, size, f) != NULL) {
+		boot[strcspn(boot, "\n")] = '\0';
+		ret = boot[0] ? 0 : -1;
+	}
+
+	fclose(f);
+	return ret;
+}
+
+/* Marks absent the registers of one instance, entries are grouped by instance */
+static void avail_set(const struct reg_registry *rr, int entry) {
+	const struct reg_instance *instance = rr->entries[entry].instance;
+	int i;
+
+	for(i = entry; i > 0 && rr->entries[i - 1].instance == instance; i--)
+		;
+	for(; i < rr->count && rr->entries[i].instance == instance; i++)
+		rr->absent[i] = 1;
+}
+
+/* First register of an instance that reads without side effects, -1 if none */
+static int avail_probe(const struct reg_registry *rr, int entry) {
+	const struct reg_instance *instance = rr->entries[entry].instance;
+	int i;
+
+	for(i = entry; i < rr->count && rr->entries[i].instance == instance; i++) {
+		if(rr->entries[i].reg->access == REG_READ_SAFE)
+			return i;
+	}
+	return -1;
+}
+
+/*
+ * Opens the list without following a link, and only if it belongs to the
+ * user running devicedbg and nobody else can write it: an absent module is
+ * never read, a forged list would hide modules
+ * Output:
+ *	the stream, NULL if the list is missing or not trusted
+ */
+static FILE *avail_open(const char *path, int flags) {
+	struct stat st;
+	FILE *f;
+	int fd;
+
+	if((fd = open(path, flags | O_NOFOLLOW, 0644)) == -1)
+		return NULL;
+
+	if(fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_uid != geteuid() ||
+	   (st.st_mode & (S_IWGRP | S_IWOTH)) != 0) {
+		fprintf(stderr, "devicedbg: %s is not trusted, not used\n", path);
+		close(fd);
+		return NULL;
+	}
+
+	if((f = fdopen(fd, (flags & O_ACCMODE) == O_RDONLY ? "r" : "w")) == NULL)
+		close(fd);
+	return f;
+}
+
+/*
+ * Takes the absent modules from the list of the running boot
+ * Output:
+ *	0 if the list was used, -1 if it is missing or stale
+ */
+static int avail_load(const struct reg_registry *rr, const char *path, const char *boot) {
+	char line[256], header[256];
+	int matched = 0, i;
+	FILE *f;
+
+	if((f = avail_open(path, O_RDONLY)) == NULL)
+		return -1;
+
+	// the header names the boot and the memory file
+	snprintf(header, sizeof(header), AVAIL_HEADER "# boot %s\n# memory %s\n", boot,
+		 mem_get_path());
+
+	while(fgets(line, sizeof(line), f) != NULL) {
+		if(matched < (int) strlen(header)) {
+			if(strncmp(line, header + matched, strlen(line)) != 0)
+				break;
+			matched += strlen(line);
+			continue;
+		}
+
+		line[strcspn(line, "\n")] = '\0';
+
+		for(i = 0; i < rr->count; i++) {
+			if(strcmp(rr->entries[i].instance->name, line) == 0) {
+				avail_set(rr, i);
+				break;
+			}
+		}
+	}
+
+	fclose(f);
+
+	if(matched == (int) strlen(header))
+		return 0;
+
+	memset(rr->absent, 0, rr->count);
+	return -1;
+}
+
+static void avail_save(const struct reg_registry *rr, const char *path, const char *boot) {
+	FILE *f;
+	int i;
+
+	// only a cache, the modules are probed again if it cannot be written
+	if((f = avail_open(path, O_WRONLY | O_CREAT | O_TRUNC)) == NULL)
+		return;
+
+	fprintf(f, AVAIL_HEADER "# boot %s\n# memory %s\n", boot, mem_get_path());
+	for(i = 0; i < rr->count; i++) {
+		if(rr->absent[i] && (i == 0 || rr->entries[i - 1].instance != rr->entries[i].instance))
+			fprintf(f, "%s\n", rr->entries[i].instance->name);
+	}
+
+	if(fclose(f) == EOF)
+		unlink(path);
+}
+
+/*
+ * Tells from its module state register whether an instance can be accessed now
+ * Output:
+ *	1 if it is clocked or its state is not known, 0 if it is not
+ */
+int avail_clocked(const struct reg_instance *instance) {
+	uint32_t v;
+
+	return instance->clock == 0 || mem_try_read32(instance->clock, &v) == -1 ||
+	       (v & instance->clock_off) == 0;
+}
+
+/*
+ * Finds the modules of the registry which are not available
+ * Input:
+ *	const struct reg_registry *rr	- registry of the detected family
+ *	int reprobe			- probe again, even with a list of this boot
+ */
+void avail_init(const struct reg_registry *rr, int reprobe) {
+	char path[256], boot[64];
+	uint32_t v;
+	int i, n = 0, off = 0, has_boot, probe;
+
+	avail_path(rr, path, sizeof(path));
+	has_boot = avail_boot(boot, sizeof(boot)) == 0;
+
+	if(!has_boot || reprobe || avail_load(rr, path, boot) == -1) {
+		for(i = 0; i < rr->count; i++) {
+			if((i == 0 || rr->entries[i - 1].instance != rr->entries[i].instance) &&
+			   avail_clocked(rr->entries[i].instance) &&
+			   (probe = avail_probe(rr, i)) >= 0 &&
+			   mem_try_read32(rr->entries[probe].addr, &v) == -1)
+				avail_set(rr, i);
+		}
+		if(has_boot)
+			avail_save(rr, path, boot);
+	}
+
+	for(i = 0; i < rr->count; i++) {
+		if(i > 0 && rr->entries[i - 1].instance == rr->entries[i].instance)
+			continue;
+		if(rr->absent[i])
+			fprintf(stderr, "%s%s", n++ ? "," : "devicedbg: not available: ",
+				rr->entries[i].instance->name);
+	}
+	if(n)
+		fprintf(stderr, "\n");
+
+	for(i = 0; i < rr->count; i++) {
+		if(i > 0 && rr->entries[i - 1].instance == rr->entries[i].instance)
+			continue;
+		if(!rr->absent[i] && !avail_clocked(rr->entries[i].instance))
+			fprintf(stderr, "%s%s", off++ ? "," : "devicedbg: not clocked: ",
+				rr->entries[i].instance->name);
+	}
+	if(off)
+		fprintf(stderr, "\n");
+}
+
+/*
+ * Marks the module of a register absent after a bus error, and adds it to the
+ * list of the boot
+ * Input:
+ *	const struct reg_registry *rr	- registry
+ *	int entry			- faulting register
+ */
+void avail_mark(const struct reg_registry *rr, int entry) {
+	char path[256], qname[REG_NAME_LEN];
+	FILE *f;
+
+	pthread_mutex_lock(&avail_lock);
+
+	if(!rr->absent[entry]) {
+		avail_set(rr, entry);
+		fprintf(stderr, "devicedbg: bus error reading %s, %s is not available\n",
+			reg_entry_name(&rr->entries[entry], qname), rr->entries[entry].instance->name);
+
+		avail_path(rr, path, sizeof(path));
+		if((f = avail_open(path, O_WRONLY | O_APPEND)) != NULL) {
+			fprintf(f, "%s\n", rr->entries[entry].instance->name);
+			fclose(f);
+		}
+	}
+
+	pthread_mutex_unlock(&avail_lock);
+}
@@ -0,0 +1,450 @@
+/*
+ * client.c : thin client of the devicedbg daemon
+ *
+ * The client never touches the hardware. It asks the daemon which family it
+ * runs on, builds the same register registry from the built-in tables to
+ * resolve names, and checks that both sides agree on the table hash.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include "devicedbg.h"
+#include "proto.h"
+
+/* Sends a request and waits for its reply
+ * Output:
+ *	reply payload (to be freed) or NULL, the reason is printed
+ */
+static uint8_t *client_call(int fd, int op, const void *req, uint32_t req_len, uint32_t *len) {
+	struct dd_hdr hdr;
+	uint8_t *payload;
+
+	if(dd_send(fd, op, 0, req, req_len) == -1 || dd_recv(fd, &hdr, &payload) == -1) {
+		fprintf(stderr, "devicedbg: %s\n", strerror(errno));
+		return NULL;
+	}
+
+	if(hdr.status != DD_OK) {
+		fprintf(stderr, "devicedbg: %s\n", dd_strerror(hdr.status));
+		free(payload);
+		return NULL;
+	}
+
+	*len = hdr.len;
+	return payload;
+}
+
+/*
+ * Builds the registry of the family a daemon runs on from its DD_OP_INFO reply
+ * Output:
+ *	0 on success, -1 if the tables differ from the daemon's, the reason is printed
+ */
+int client_info_registry(const uint8_t *info, uint32_t len, struct reg_registry *rr) {
+	const struct soc_family *family;
+
+	if(len < 12 || (family = find_family_type(dd_get32(info))) == NULL) {
+		fprintf(stderr, "devicedbg: daemon runs on an unknown processor\n");
+		return -1;
+	}
+
+	if(registry_build(rr, family) == -1) FATAL;
+
+	if(rr->hash != dd_get32(info + 8) || rr->count != dd_get32(info + 4)) {
+		fprintf(stderr, "devicedbg: register tables differ from the daemon's "
+			"(hash %08X, daemon %08X)\n", rr->hash, dd_get32(info + 8));
+		registry_free(rr);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Decoded fields of a value for display, valid until the next call */
+static const char *client_fields(const struct reg_entry *e, uint32_t value) {
+	return reg_decode_cached(e->reg, value);
+}
+
+/* Builds the registry of the family the daemon runs on */
+static int client_registry(int fd, struct reg_registry *rr) {
+	uint8_t *info;
+	uint32_t len;
+	int ret;
+
+	if((info = client_call(fd, DD_OP_INFO, NULL, 0, &len)) == NULL)
+		return -1;
+
+	ret = client_info_registry(info, len, rr);
+	free(info);
+	return ret;
+}
+
+static int client_read(int fd, const struct reg_registry *rr, int argc, char **argv) {
+	char qname[REG_NAME_LEN];
+	uint8_t *req, *reply;
+	uint32_t len;
+	int i, *idx;
+
+	req = malloc(4 + 4 * argc);
+	idx = malloc(argc * sizeof(int));
+	if(req == NULL || idx == NULL) FATAL;
+
+	// all the registers go in a single batch
+	dd_put32(req, argc);
+	for(i = 0; i < argc; i++) {
+		if((idx[i] = registry_lookup(rr, argv[i])) < 0) {
+			fprintf(stderr, "devicedbg: unknown register %s\n", argv[i]);
+			free(req);
+			free(idx);
+			return 1;
+		}
+		dd_put32(req + 4 + 4 * i, rr->entries[idx[i]].addr);
+	}
+
+	reply = client_call(fd, DD_OP_READ_BATCH, req, 4 + 4 * argc, &len);
+	free(req);
+	if(reply == NULL) {
+		free(idx);
+		return 1;
+	}
+
+	for(i = 0; i < argc && len == 4 + 4 * (uint32_t) argc; i++) {
+		const struct reg_entry *e = &rr->entries[idx[i]];
+		uint32_t v = dd_get32(reply + 4 + 4 * i);
+
+		printf("%-32s 0x%08lX: 0x%08X%s\n", reg_entry_name(e, qname), e->addr, v,
+		       client_fields(e, v));
+	}
+
+	free(reply);
+	free(idx);
+	return 0;
+}
+
+static int client_set(int fd, const struct reg_registry *rr, const char *name) {
+	char qname[REG_NAME_LEN];
+	uint8_t *reply, *p;
+	uint32_t len, n, idx;
+
+	if((reply = client_call(fd, DD_OP_READ_SET, name, strlen(name), &len)) == NULL)
+		return 1;
+
+	n = len >= 4 ? dd_get32(reply) : 0;
+	for(p = reply + 4; n > 0 && len == 4 + 8 * dd_get32(reply); n--, p += 8) {
+		if((idx = dd_get32(p)) >= (uint32_t) rr->count)
+			continue;
+		printf("%-32s 0x%08lX: 0x%08X%s\n", reg_entry_name(&rr->entries[idx], qname),
+		       rr->entries[idx].addr, dd_get32(p + 4), client_fields(&rr->entries[idx], dd_get32(p + 4)));
+	}
+
+	free(reply);
+	return 0;
+}
+
+static int client_snapshot(int fd, const struct reg_registry *rr) {
+	char qname[REG_NAME_LEN];
+	uint8_t *reply;
+	uint32_t len;
+	int i;
+
+	if((reply = client_call(fd, DD_OP_SNAPSHOT, NULL, 0, &len)) == NULL)
+		return 1;
+
+	if(len != 8 + 4 * (uint32_t) rr->count || dd_get32(reply) != rr->hash) {
+		fprintf(stderr, "devicedbg: snapshot does not match the register tables\n");
+		free(reply);
+		return 1;
+	}
+
+	for(i = 0; i < rr->count; i++)
+		printf("%-32s 0x%08lX: 0x%08X%s\n", reg_entry_name(&rr->entries[i], qname),
+		       rr->entries[i].addr, dd_get32(reply + 8 + 4 * i),
+		       client_fields(&rr->entries[i], dd_get32(reply + 8 + 4 * i)));
+
+	free(reply);
+	return 0;
+}
+
+static int client_diff(int fd, const struct reg_registry *rr, unsigned int seconds) {
+	char qname[REG_NAME_LEN];
+	uint8_t *reply, *p;
+	uint32_t len, n, idx;
+
+	// the first DIFF only records the baseline
+	if((reply = client_call(fd, DD_OP_DIFF, NULL, 0, &len)) == NULL)
+		return 1;
+	free(reply);
+
+	sleep(seconds);
+
+	if((reply = client_call(fd, DD_OP_DIFF, NULL, 0, &len)) == NULL)
+		return 1;
+
+	n = len >= 4 ? dd_get32(reply) : 0;
+	if(len != 4 + 12 * n) {
+		fprintf(stderr, "devicedbg: malformed diff reply\n");
+		free(reply);
+		return 1;
+	}
+
+	for(p = reply + 4; n > 0; n--, p += 12) {
+		if((idx = dd_get32(p)) >= (uint32_t) rr->count)
+			continue;
+		printf("%-32s 0x%08lX: 0x%08X -> 0x%08X%s\n", reg_entry_name(&rr->entries[idx], qname),
+		       rr->entries[idx].addr, dd_get32(p + 4), dd_get32(p + 8),
+		       client_fields(&rr->entries[idx], dd_get32(p + 8)));
+	}
+
+	free(reply);
+	return 0;
+}
+
+/*
+ * Subscribes to register patterns and prints the changes pushed by the
+ * daemon until the connection is closed
+ */
+static int client_watch(int fd, const struct reg_registry *rr, int argc, char **argv) {
+	char qname[REG_NAME_LEN];
+	struct dd_hdr hdr;
+	uint8_t *payload, *p;
+	uint32_t n, idx;
+	int i, pending = argc;
+
+	if(argc < 1) {
+		fprintf(stderr, "devicedbg: missing register pattern\n");
+		return 1;
+	}
+
+	// events may already come in between the subscription replies
+	for(i = 0; i < argc; i++) {
+		if(dd_send(fd, DD_OP_SUBSCRIBE, 0, argv[i], strlen(argv[i])) == -1)
+			goto fail;
+	}
+
+	while(dd_recv(fd, &hdr, &payload) == 0) {
+		p = payload;
+		n = hdr.len >= 4 ? dd_get32(p) : 0;
+
+		switch(hdr.op) {
+			case DD_OP_SUBSCRIBE:
+				i = argc - pending--;
+				if(hdr.status != DD_OK)
+					fprintf(stderr, "devicedbg: %s: %s\n", argv[i], dd_strerror(hdr.status));
+				else
+					printf("watching %u registers for %s\n", n, argv[i]);
+				break;
+
+			case DD_OP_EVENT:
+				n = hdr.len >= 8 ? dd_get32(p + 4) : 0;
+				if(hdr.len != 8 + 12 * n)
+					break;
+				for(p += 8; n > 0; n--, p += 12) {
+					if((idx = dd_get32(p)) >= (uint32_t) rr->count)
+						continue;
+					printf("%-32s 0x%08lX: 0x%08X -> 0x%08X%s\n",
+					       reg_entry_name(&rr->entries[idx], qname), rr->entries[idx].addr, dd_get32(p + 4), dd_get32(p + 8),
+					       client_fields(&rr->entries[idx], dd_get32(p + 8)));
+				}
+				break;
+
+			case DD_OP_DROPPED:
+				printf("%u events dropped\n", n);
+				break;
+		}
+
+		free(payload);
+		fflush(stdout);
+	}
+
+fail:
+	fprintf(stderr, "devicedbg: %s\n", strerror(errno));
+	return 1;
+}
+
+/* Prints the latest rollup windows of a register, tier is "1s", "1m" or "1h" */
+static int client_rollup(int fd, const struct reg_registry *rr, const char *tier,
+			 const char *name, uint32_t max) {
+	static const char *tiers[RU_TIERS] = { "1s", "1m", "1h" };
+	uint8_t req[12], *reply, *p;
+	uint32_t len, n;
+	char when[32], qname[REG_NAME_LEN];
+	time_t start;
+	int t, idx;
+
+	for(t = 0; t < RU_TIERS && strcmp(tier, tiers[t]) != 0; t++)
+		;
+	if(t == RU_TIERS) {
+		fprintf(stderr, "devicedbg: tier is one of 1s, 1m, 1h\n");
+		return 1;
+	}
+
+	if((idx = registry_lookup(rr, name)) < 0) {
+		fprintf(stderr, "devicedbg: unknown register %s\n", name);
+		return 1;
+	}
+
+	dd_put32(req, t);
+	dd_put32(req + 4, rr->entries[idx].addr);
+	dd_put32(req + 8, max);
+	if((reply = client_call(fd, DD_OP_ROLLUP, req, sizeof(req), &len)) == NULL)
+		return 1;
+
+	n = len >= 8 ? dd_get32(reply + 4) : 0;
+	if(len != 8 + 24 * n) {
+		fprintf(stderr, "devicedbg: malformed reply\n");
+		free(reply);
+		return 1;
+	}
+
+	printf("%s 0x%08lX, %u windows of %u s\n", reg_entry_name(&rr->entries[idx], qname),
+	       rr->entries[idx].addr, n, dd_get32(reply));
+	printf("%-19s %8s %10s %10s %10s %8s\n", "start", "samples", "last", "min", "max", "changes");
+	for(p = reply + 8; n > 0; n--, p += 24) {
+		start = dd_get32(p);
+		strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", localtime(&start));
+		printf("%-19s %8u 0x%08X 0x%08X 0x%08X %8u%s\n", when, dd_get32(p + 4),
+		       dd_get32(p + 8), dd_get32(p + 12), dd_get32(p + 16), dd_get32(p + 20),
+		       client_fields(&rr->entries[idx], dd_get32(p + 8)));
+	}
+
+	free(reply);
+	return 0;
+}
+
+#define BENCH_WINDOW	16	/* requests in flight */
+
+/*
+ * Measures the read rate for growing batch sizes, keeping BENCH_WINDOW
+ * batches in flight so that the round trip is not part of the figure. The
+ * batches cycle through the registers read without side effects, the daemon
+ * refuses a batch holding any other (DD_EACCES).
+ */
+static int client_bench(int fd, const struct reg_registry *rr, double seconds) {
+	static const int sizes[] = { 1, 4, 16, 64, 256, 1024 };
+	struct dd_hdr hdr;
+	uint8_t *req, *reply;
+	uint64_t start, elapsed;
+	long sent, done;
+	int s, i, n, *readable, num_readable;
+
+	if((req = malloc(4 + 4 * rr->count)) == NULL ||
+	   (readable = malloc(rr->count * sizeof(int))) == NULL) FATAL;
+
+	if((num_readable = registry_readable(rr, readable)) == 0) {
+		fprintf(stderr, "devicedbg: no register to read without side effects\n");
+		free(readable);
+		free(req);
+		return 1;
+	}
+
+	printf("%8s %12s %12s %12s\n", "batch", "batches/s", "reads/s", "us/batch");
+
+	for(s = 0; s < ARRAY_SIZE(int, sizes) && sizes[s] <= rr->count; s++) {
+		n = sizes[s];
+		dd_put32(req, n);
+		for(i = 0; i < n; i++)
+			dd_put32(req + 4 + 4 * i, rr->entries[readable[i % num_readable]].addr);
+
+		sent = done = 0;
+		start = now_ns();
+		do {
+			elapsed = now_ns() - start;
+			while(sent - done < BENCH_WINDOW && elapsed < seconds * 1e9) {
+				if(dd_send(fd, DD_OP_READ_BATCH, 0, req, 4 + 4 * n) == -1)
+					goto fail;
+				sent++;
+			}
+			if(sent == done)
+				break;
+
+			if(dd_recv(fd, &hdr, &reply) == -1)
+				goto fail;
+			free(reply);
+			if(hdr.status != DD_OK) {
+				fprintf(stderr, "devicedbg: %s\n", dd_strerror(hdr.status));
+				free(readable);
+				free(req);
+				return 1;
+			}
+			done++;
+		} while(done < sent);
+
+		elapsed = now_ns() - start;
+		if(done == 0)
+			continue;
+		printf("%8d %12.0f %12.0f %12.2f\n", n, done / (elapsed / 1e9),
+		       done * (double) n / (elapsed / 1e9), elapsed / 1e3 / done);
+	}
+
+	free(readable);
+	free(req);
+	return 0;
+
+fail:
+	fprintf(stderr, "devicedbg: %s\n", strerror(errno));
+	free(readable);
+	free(req);
+	return 1;
+}
+
+/*
+ * Runs one client command against the daemon
+ * Input:
+ *	const char *endpoint	- daemon endpoint, several separated by commas
+ *				  run the command on all of them concurrently
+ *	int argc, char **argv	- command and its arguments:
+ *				  read { reg }..., set name, snapshot,
+ *				  diff [seconds], watch pattern...,
+ *				  bench [seconds], rollup tier reg [n]
+ *
+ * Output:
+ *	exit status of the program
+ */
+int run_client(const char *endpoint, int argc, char **argv) {
+	struct reg_registry rr;
+	int fd, ret = 1;
+
+	if(argc < 1) {
+		fprintf(stderr, "devicedbg: missing client command\n");
+		return 1;
+	}
+
+	if(strchr(endpoint, ',') != NULL)
+		return run_remote(endpoint, argc, argv);
+
+	if((fd = net_connect(endpoint, 0)) == -1) {
+		fprintf(stderr, "devicedbg: cannot connect to %s: %s\n", endpoint, strerror(errno));
+		return 1;
+	}
+
+	if(client_registry(fd, &rr) == -1) {
+		close(fd);
+		return 1;
+	}
+
+	if(strcmp(argv[0], "read") == 0)
+		ret = client_read(fd, &rr, argc - 1, argv + 1);
+	else if(strcmp(argv[0], "snapshot") == 0)
+		ret = client_snapshot(fd, &rr);
+	else if(strcmp(argv[0], "diff") == 0)
+		ret = client_diff(fd, &rr, argc > 1 ? atoi(argv[1]) : 1);
+	else if(strcmp(argv[0], "set") == 0 && argc > 1)
+		ret = client_set(fd, &rr, argv[1]);
+	else if(strcmp(argv[0], "watch") == 0)
+		ret = client_watch(fd, &rr, argc - 1, argv + 1);
+	else if(strcmp(argv[0], "bench") == 0)
+		ret = client_bench(fd, &rr, argc > 1 ? atof(argv[1]) : 1.0);
+	else if(strcmp(argv[0], "rollup") == 0 && argc > 2)
+		ret = client_rollup(fd, &rr, argv[1], argv[2], argc > 3 ? atoi(argv[3]) : 60);
+	else
+		fprintf(stderr, "devicedbg: unknown client command %s\n", argv[0]);
+
+	registry_free(&rr);
+	close(fd);
+	return ret;
+}
@@ -0,0 +1,348 @@
+/*
+ * collector.c : periodic snapshots of a fleet of agents stored in snapshot files
+ *
+ * One epoll loop drives a connection per agent. Every interval each agent is
+ * asked for one snapshot; an agent whose previous snapshot has not come back
+ * yet is skipped for that round rather than sent another request, so a slow
+ * board or link only lowers its own rate and the collector never buffers more
+ * than one snapshot per agent.
+ *
+ * The DD_OP_INFO reply of an agent is checked against the built-in tables of
+ * its family, and every snapshot against the same registry hash, before it is
+ * appended to "<dir>/<agent>.snap" (see snapfile.c). Agents that go away are
+ * reconnected after a delay.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+
+#include "devicedbg.h"
+#include "proto.h"
+
+#define CO_MAX_AGENTS	4096
+#define CO_MAX_EVENTS	256
+#define CO_RETRY	(5 * 1000000000ULL)	/* before reconnecting an agent */
+
+enum { CO_IDLE, CO_CONNECTING, CO_INFO, CO_READY };
+
+struct co_agent {
+	char endpoint[DD_SNAP_SOURCE];
+	int fd, state, snap_fd;
+	const struct reg_registry *rr;
+	uint8_t *in;
+	size_t in_len, in_size;
+	int outstanding;		/* a snapshot request is in flight */
+	uint64_t retry_at;
+	uint64_t snapshots, skipped, failures;
+};
+
+static struct co_agent *agents;
+static int num_agents, epfd;
+static const char *snap_dir;
+
+static struct reg_registry registries[16];	/* per family, built on demand */
+
+static volatile sig_atomic_t collector_quit;
+
+static void collector_signal(int sig) {
+	collector_quit = 1;
+}
+
+static const struct reg_registry *collector_registry(const struct soc_family *family) {
+	struct reg_registry *rr = &registries[family - soc_families];
+
+	if(rr->entries == NULL && registry_build(rr, family) == -1) FATAL;
+	return rr;
+}
+
+static void agent_drop(struct co_agent *a, const char *why) {
+	fprintf(stderr, "devicedbg: %s: %s\n", a->endpoint, why);
+
+	if(a->fd >= 0)
+		close(a->fd);
+	if(a->snap_fd >= 0)
+		close(a->snap_fd);
+
+	a->fd = a->snap_fd = -1;
+	a->state = CO_IDLE;
+	a->in_len = 0;
+	a->outstanding = 0;
+	a->retry_at = now_ns() + CO_RETRY;
+	a->failures++;
+}
+
+static void agent_watch(struct co_agent *a, int op, uint32_t events) {
+	struct epoll_event ev;
+
+	memset(&ev, 0, sizeof(ev));
+	ev.events = events;
+	ev.data.u32 = a - agents;
+	if(epoll_ctl(epfd, op, a->fd, &ev) == -1) FATAL;
+}
+
+static void agent_connect(struct co_agent *a) {
+	if((a->fd = net_connect(a->endpoint, 1)) == -1) {
+		agent_drop(a, strerror(errno));
+		return;
+	}
+
+	a->state = CO_CONNECTING;
+	agent_watch(a, EPOLL_CTL_ADD, EPOLLOUT);
+}
+
+/* Sends a request without payload, the socket is empty but for at most one */
+static int agent_request(struct co_agent *a, int op) {
+	uint8_t hdr[DD_HDR_SIZE];
+
+	dd_put_hdr(hdr, op, 0, 0);
+	return send(a->fd, hdr, sizeof(hdr), MSG_NOSIGNAL) == sizeof(hdr) ? 0 : -1;
+}
+
+static void agent_connected(struct co_agent *a) {
+	socklen_t len = sizeof(int);
+	int err = 0;
+
+	if(getsockopt(a->fd, SOL_SOCKET, SO_ERROR, &err, &len) == -1 || err != 0) {
+		agent_drop(a, strerror(err ? err : errno));
+		return;
+	}
+
+	agent_watch(a, EPOLL_CTL_MOD, EPOLLIN);
+	a->state = CO_INFO;
+	if(agent_request(a, DD_OP_INFO) == -1)
+		agent_drop(a, strerror(errno));
+}
+
+static void agent_info(struct co_agent *a, const uint8_t *p, uint32_t len) {
+	const struct soc_family *family;
+	char path[4096], name[DD_SNAP_SOURCE], *c;
+
+	if(len < 12 || (family = find_family_type(dd_get32(p))) == NULL) {
+		agent_drop(a, "unknown processor");
+		return;
+	}
+
+	a->rr = collector_registry(family);
+	if(a->rr->hash != dd_get32(p + 8) || a->rr->count != dd_get32(p + 4)) {
+		agent_drop(a, "register tables differ from the collector's");
+		return;
+	}
+
+	strcpy(name, a->endpoint);
+	for(c = name; *c; c++) {
+		if(*c == '/' || *c == ':')
+			*c = '_';
+	}
+	snprintf(path, sizeof(path), "%s/%s.snap", snap_dir, name);
+
+	if((a->snap_fd = snap_open(path, family->type, a->rr->hash, a->rr->count, a->endpoint)) == -1) {
+		fprintf(stderr, "devicedbg: %s: %s\n", path, strerror(errno));
+		agent_drop(a, "cannot store its snapshots");
+		return;
+	}
+
+	a->state = CO_READY;
+}
+
+static void agent_snapshot(struct co_agent *a, const uint8_t *p, uint32_t len) {
+	struct timespec ts;
+
+	a->outstanding = 0;
+
+	if(len != 8 + 4 * (uint32_t) a->rr->count || dd_get32(p) != a->rr->hash) {
+		agent_drop(a, "snapshot does not match the register tables");
+		return;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	if(snap_append(a->snap_fd, ts.tv_sec * 1000000000ULL + ts.tv_nsec, p + 8, a->rr->count) == -1) {
+		agent_drop(a, strerror(errno));
+		return;
+	}
+
+	a->snapshots++;
+}
+
+static void agent_input(struct co_agent *a) {
+	struct dd_hdr hdr;
+	size_t off = 0;
+	ssize_t n;
+
+	if(dd_reserve(&a->in, &a->in_size, a->in_len, 16384) == -1) FATAL;
+
+	n = read(a->fd, a->in + a->in_len, a->in_size - a->in_len);
+	if(n <= 0) {
+		if(n < 0 && (errno == EAGAIN || errno == EINTR))
+			return;
+		agent_drop(a, n == 0 ? "connection closed" : strerror(errno));
+		return;
+	}
+	a->in_len += n;
+
+	while(a->state >= CO_INFO && a->in_len - off >= DD_HDR_SIZE) {
+		dd_get_hdr(a->in + off, &hdr);
+		if(hdr.magic != DD_MAGIC || hdr.len > DD_MAX_PAYLOAD) {
+			agent_drop(a, "protocol error");
+			return;
+		}
+		if(a->in_len - off < DD_HDR_SIZE + hdr.len)
+			break;
+
+		if(hdr.status != DD_OK)
+			agent_drop(a, dd_strerror(hdr.status));
+		else if(hdr.op == DD_OP_INFO && a->state == CO_INFO)
+			agent_info(a, a->in + off + DD_HDR_SIZE, hdr.len);
+		else if(hdr.op == DD_OP_SNAPSHOT && a->state == CO_READY)
+			agent_snapshot(a, a->in + off + DD_HDR_SIZE, hdr.len);
+
+		off += DD_HDR_SIZE + hdr.len;
+	}
+
+	if(a->state == CO_IDLE)
+		return;
+
+	memmove(a->in, a->in + off, a->in_len - off);
+	a->in_len -= off;
+}
+
+/* One round: a snapshot request to every ready agent without one in flight */
+static void collector_tick(uint64_t now) {
+	int i;
+
+	for(i = 0; i < num_agents; i++) {
+		struct co_agent *a = &agents[i];
+
+		if(a->state == CO_IDLE && now >= a->retry_at)
+			agent_connect(a);
+		else if(a->state == CO_READY && a->outstanding)
+			a->skipped++;
+		else if(a->state == CO_READY) {
+			if(agent_request(a, DD_OP_SNAPSHOT) == -1)
+				agent_drop(a, strerror(errno));
+			else
+				a->outstanding = 1;
+		}
+	}
+}
+
+static void collector_report(uint64_t elapsed) {
+	uint64_t snapshots = 0, skipped = 0;
+	int i;
+
+	printf("%-24s %10s %10s %10s\n", "agent", "snapshots", "skipped", "failures");
+	for(i = 0; i < num_agents; i++) {
+		struct co_agent *a = &agents[i];
+
+		printf("%-24s %10llu %10llu %10llu\n", a->endpoint, (unsigned long long) a->snapshots,
+		       (unsigned long long) a->skipped, (unsigned long long) a->failures);
+		snapshots += a->snapshots;
+		skipped += a->skipped;
+	}
+
+	printf("%d agents: %llu snapshots (%.1f/s), %llu skipped\n", num_agents,
+	       (unsigned long long) snapshots, snapshots / (elapsed / 1e9),
+	       (unsigned long long) skipped);
+}
+
+/*
+ * Collects snapshots until SIGINT or SIGTERM
+ * Input:
+ *	const char *dir		- directory of the snapshot files
+ *	int interval_ms		- period of the snapshot requests
+ *	int argc, char **argv	- agent endpoints, each may be a comma separated list
+ *
+ * Output:
+ *	exit status of the program
+ */
+int run_collector(const char *dir, int interval_ms, int argc, char **argv) {
+	struct epoll_event events[CO_MAX_EVENTS];
+	struct sigaction sa;
+	uint64_t now, start, next_tick;
+	char *list, *tok, *save;
+	int i, n, timeout;
+
+	if((agents = calloc(CO_MAX_AGENTS, sizeof(struct co_agent))) == NULL) FATAL;
+	snap_dir = dir;
+
+	for(i = 0; i < argc; i++) {
+		if((list = strdup(argv[i])) == NULL) FATAL;
+		for(tok = strtok_r(list, ",", &save); tok != NULL; tok = strtok_r(NULL, ",", &save)) {
+			struct co_agent *a = &agents[num_agents];
+
+			if(num_agents == CO_MAX_AGENTS || strlen(tok) >= sizeof(a->endpoint)) {
+				fprintf(stderr, "devicedbg: too many agents or bad endpoint %s\n", tok);
+				return 1;
+			}
+			strcpy(a->endpoint, tok);
+			a->fd = a->snap_fd = -1;
+			num_agents++;
+		}
+		free(list);
+	}
+
+	if(num_agents == 0) {
+		fprintf(stderr, "devicedbg: no agent to collect from\n");
+		return 1;
+	}
+
+	if((epfd = epoll_create1(EPOLL_CLOEXEC)) == -1) FATAL;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = collector_signal;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	printf("collecting from %d agents every %d ms in %s\n", num_agents, interval_ms, dir);
+	fflush(stdout);
+
+	start = next_tick = now_ns();
+	while(!collector_quit) {
+		now = now_ns();
+		if(now >= next_tick) {
+			collector_tick(now);
+			next_tick += interval_ms * 1000000ULL;
+			if(next_tick <= now)
+				next_tick = now + interval_ms * 1000000ULL;
+		}
+		timeout = (next_tick - now + 999999) / 1000000;
+
+		if((n = epoll_wait(epfd, events, CO_MAX_EVENTS, timeout)) == -1) {
+			if(errno == EINTR)
+				continue;
+			FATAL;
+		}
+
+		for(i = 0; i < n; i++) {
+			struct co_agent *a = &agents[events[i].data.u32];
+
+			if(a->state == CO_CONNECTING)
+				agent_connected(a);
+			else if(a->state != CO_IDLE)
+				agent_input(a);
+		}
+	}
+
+	collector_report(now_ns() - start);
+
+	for(i = 0; i < num_agents; i++) {
+		if(agents[i].fd >= 0)
+			close(agents[i].fd);
+		if(agents[i].snap_fd >= 0)
+			close(agents[i].snap_fd);
+		free(agents[i].in);
+	}
+	for(i = 0; i < ARRAY_SIZE(struct reg_registry, registries); i++)
+		registry_free(&registries[i]);
+
+	close(epfd);
+	free(agents);
+	return 0;
+}
@@ -0,0 +1,726 @@
+/*
+ * daemon.c : long running devicedbg serving register reads over a socket
+ *
+ * The processor is detected and the register pages are mapped once at
+ * startup, then any number of clients are served from a single poll() loop
+ * using the protocol described in proto.h. The endpoint is a Unix socket for
+ * local clients or a TCP address (see net.c), the daemon is then the agent
+ * of a board read from a workstation. For load tests, one process can listen
+ * on several consecutive endpoints and stand for as many simulated agents. Sockets are non-blocking and
+ * every connection has its own input and output buffers; a connection whose
+ * replies are not being consumed is not read from until it catches up.
+ *
+ * Requests may be pipelined, all the complete frames received on a connection
+ * are executed in order. Batches and named sets go through a read plan (see
+ * plan.c); the plan of the last named set of a connection is kept so that
+ * polling the same set again costs one pass over the mappings.
+ *
+ * Connections may also subscribe to patterns of registers. While there is at
+ * least one subscriber, a single sampler reads every register once per
+ * interval and compares with the previous sample; each change is queued on
+ * the subscribers whose filter holds the register. The queues are bounded: a
+ * subscriber that does not drain its socket loses the newest events and is
+ * told how many with a DD_OP_DROPPED frame, the sampler never waits for it.
+ *
+ * With a retention, the sampler runs all the time and also feeds the rollups
+ * of every register (see rollup.c), queried with DD_OP_ROLLUP.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include "devicedbg.h"
+#include "proto.h"
+
+#define DD_MAX_CLIENTS	1024
+#define DD_MAX_LISTEN	1024			/* simulated agents */
+#define DD_READ_CHUNK	4096
+#define DD_OUT_LIMIT	(4 * 1024 * 1024)	/* stop reading above this backlog */
+#define DD_EVENT_LIMIT	(64 * 1024)		/* hold events above this backlog */
+#define DD_SUB_QUEUE	4096			/* events queued per subscriber */
+
+struct dd_event {
+	uint32_t index, old, new;
+};
+
+struct dd_conn {
+	int fd;
+	uint8_t *in;
+	size_t in_len, in_size;
+	uint8_t *out;
+	size_t out_off, out_len, out_size;
+	uint32_t *baseline;		/* last values sent by SNAPSHOT/DIFF */
+	char set_name[REG_NAME_LEN];	/* last READ_SET and its plan */
+	int *set_indices;
+	struct read_plan set_plan;
+	uint8_t *filter;		/* subscribed registers, one bit each */
+	struct dd_event *queue;		/* ring of events not sent yet */
+	unsigned int q_head, q_len;
+	uint32_t dropped;		/* events lost since the last notice */
+};
+
+static const struct reg_registry *registry;
+static struct read_plan snapshot_plan;	/* every register, registry order */
+static uint32_t *scratch;		/* one registry worth of values */
+static int *scratch_indices;
+
+static struct dd_conn conns[DD_MAX_CLIENTS];
+static int num_conns;
+
+static uint32_t *sample_prev, *sample_cur;	/* shared by all subscribers */
+static int sample_valid;
+static uint64_t samples;
+static int rollups;			/* the sampler feeds rollup.c */
+
+static volatile sig_atomic_t daemon_quit;
+
+static void daemon_signal(int sig) {
+	daemon_quit = 1;
+}
+
+/* Queues a reply header and returns where its payload has to be written
+ * Output:
+ *	payload pointer or NULL on allocation failure
+ */
+static uint8_t *conn_reply(struct dd_conn *c, int op, int status, uint32_t len) {
+	uint8_t *p;
+
+	if(dd_reserve(&c->out, &c->out_size, c->out_len, DD_HDR_SIZE + len) == -1)
+		return NULL;
+
+	p = c->out + c->out_len;
+	dd_put_hdr(p, op, status, len);
+	c->out_len += DD_HDR_SIZE + len;
+
+	return p + DD_HDR_SIZE;
+}
+
+static int conn_error(struct dd_conn *c, int op, int status) {
+	return conn_reply(c, op, status, 0) == NULL ? -1 : 0;
+}
+
+static int op_info(struct dd_conn *c) {
+	uint8_t *p = conn_reply(c, DD_OP_INFO, DD_OK, 28);
+
+	if(p == NULL)
+		return -1;
+
+	dd_put32(p, registry->family->type);
+	dd_put32(p + 4, registry->count);
+	dd_put32(p + 8, registry->hash);
+	memset(p + 12, 0, 16);
+	strncpy((char *) p + 12, registry->family->name, 15);
+
+	return 0;
+}
+
+static int op_read(struct dd_conn *c, const uint8_t *payload, uint32_t len) {
+	uint8_t *p;
+	uint32_t v;
+	int i;
+
+	if(len != 4)
+		return conn_error(c, DD_OP_READ, DD_EINVAL);
+
+	if((i = registry_find_addr(registry, dd_get32(payload))) < 0)
+		return conn_error(c, DD_OP_READ, DD_ENOENT);
+
+	if(!plan_readable(registry->entries[i].reg))
+		return conn_error(c, DD_OP_READ, DD_EACCES);
+
+	if(!avail_clocked(registry->entries[i].instance))
+		return conn_error(c, DD_OP_READ, DD_EFAULT);
+
+	if(registry->absent[i] || mem_try_read32(registry->entries[i].addr, &v) == -1) {
+		avail_mark(registry, i);
+		return conn_error(c, DD_OP_READ, DD_EFAULT);
+	}
+
+	if((p = conn_reply(c, DD_OP_READ, DD_OK, 4)) == NULL)
+		return -1;
+
+	dd_put32(p, v);
+	return 0;
+}
+
+static int conn_baseline(struct dd_conn *c) {
+	if(c->baseline == NULL)
+		c->baseline = malloc(registry->count * sizeof(uint32_t));
+
+	return c->baseline == NULL ? -1 : 0;
+}
+
+static int op_snapshot(struct dd_conn *c) {
+	uint8_t *p;
+	int i;
+
+	if(conn_baseline(c) == -1)
+		return -1;
+
+	if((p = conn_reply(c, DD_OP_SNAPSHOT, DD_OK, 8 + 4 * registry->count)) == NULL)
+		return -1;
+
+	plan_run(&snapshot_plan, c->baseline);
+
+	dd_put32(p, registry->hash);
+	dd_put32(p + 4, registry->count);
+	for(i = 0; i < registry->count; i++)
+		dd_put32(p + 8 + 4 * i, c->baseline[i]);
+
+	return 0;
+}
+
+static int op_diff(struct dd_conn *c) {
+	int first = c->baseline == NULL;
+	uint32_t n = 0;
+	uint8_t *p;
+	int i;
+
+	if(conn_baseline(c) == -1)
+		return -1;
+
+	plan_run(&snapshot_plan, scratch);
+
+	if(!first) {
+		for(i = 0; i < registry->count; i++)
+			n += scratch[i] != c->baseline[i];
+	}
+
+	if((p = conn_reply(c, DD_OP_DIFF, DD_OK, 4 + 12 * n)) == NULL)
+		return -1;
+
+	dd_put32(p, n);
+	p += 4;
+
+	for(i = 0; i < registry->count && n > 0; i++) {
+		if(scratch[i] != c->baseline[i]) {
+			dd_put32(p, i);
+			dd_put32(p + 4, c->baseline[i]);
+			dd_put32(p + 8, scratch[i]);
+			p += 12;
+		}
+	}
+
+	memcpy(c->baseline, scratch, registry->count * sizeof(uint32_t));
+	return 0;
+}
+
+static int op_read_batch(struct dd_conn *c, const uint8_t *payload, uint32_t len) {
+	struct read_plan plan;
+	uint32_t n, i;
+	uint8_t *p;
+	int idx;
+
+	if(len < 4 || (n = dd_get32(payload)) > (uint32_t) registry->count || len != 4 + 4 * n)
+		return conn_error(c, DD_OP_READ_BATCH, DD_EINVAL);
+
+	for(i = 0; i < n; i++) {
+		if((idx = registry_find_addr(registry, dd_get32(payload + 4 + 4 * i))) < 0)
+			return conn_error(c, DD_OP_READ_BATCH, DD_ENOENT);
+		if(!plan_readable(registry->entries[idx].reg))
+			return conn_error(c, DD_OP_READ_BATCH, DD_EACCES);
+		scratch_indices[i] = idx;
+	}
+
+	if(plan_build(&plan, registry, scratch_indices, n) == -1)
+		return -1;
+	plan_run(&plan, scratch);
+	plan_free(&plan);
+
+	if((p = conn_reply(c, DD_OP_READ_BATCH, DD_OK, 4 + 4 * n)) == NULL)
+		return -1;
+
+	dd_put32(p, n);
+	for(i = 0; i < n; i++)
+		dd_put32(p + 4 + 4 * i, scratch[i]);
+
+	return 0;
+}
+
+static int op_read_set(struct dd_conn *c, const uint8_t *payload, uint32_t len) {
+	uint8_t *p;
+	int i, j, n;
+
+	if(len == 0 || len >= REG_NAME_LEN)
+		return conn_error(c, DD_OP_READ_SET, DD_EINVAL);
+
+	if(c->set_indices == NULL || strlen(c->set_name) != len ||
+	   memcmp(c->set_name, payload, len) != 0) {
+		plan_free(&c->set_plan);
+		c->set_name[0] = '\0';
+
+		if(c->set_indices == NULL &&
+		   (c->set_indices = malloc(registry->count * sizeof(int))) == NULL)
+			return -1;
+
+		memcpy(c->set_name, payload, len);
+		c->set_name[len] = '\0';
+
+		// registers with side effects on read are left out of the set
+		n = registry_match(registry, c->set_name, c->set_indices);
+		for(i = j = 0; i < n; i++) {
+			if(plan_readable(registry->entries[c->set_indices[i]].reg))
+				c->set_indices[j++] = c->set_indices[i];
+		}
+		n = j;
+		if(plan_build(&c->set_plan, registry, c->set_indices, n) == -1)
+			return -1;
+	}
+
+	n = c->set_plan.n;
+	if(n == 0)
+		return conn_error(c, DD_OP_READ_SET, DD_ENOENT);
+
+	plan_run(&c->set_plan, scratch);
+
+	if((p = conn_reply(c, DD_OP_READ_SET, DD_OK, 4 + 8 * n)) == NULL)
+		return -1;
+
+	dd_put32(p, n);
+	for(i = 0; i < n; i++) {
+		dd_put32(p + 4 + 8 * i, c->set_indices[i]);
+		dd_put32(p + 8 + 8 * i, scratch[i]);
+	}
+
+	return 0;
+}
+
+static int op_rollup(struct dd_conn *c, const uint8_t *payload, uint32_t len) {
+	uint32_t tier, n;
+	uint8_t *p;
+	int i;
+
+	if(!rollups)
+		return conn_error(c, DD_OP_ROLLUP, DD_ENODATA);
+
+	if(len != 12 || (tier = dd_get32(payload)) >= RU_TIERS)
+		return conn_error(c, DD_OP_ROLLUP, DD_EINVAL);
+
+	if((i = registry_find_addr(registry, dd_get32(payload + 4))) < 0)
+		return conn_error(c, DD_OP_ROLLUP, DD_ENOENT);
+
+	n = rollup_windows(tier, dd_get32(payload + 8));
+	if((p = conn_reply(c, DD_OP_ROLLUP, DD_OK, 8 + 24 * n)) == NULL)
+		return -1;
+
+	rollup_encode(tier, i, n, p);
+	return 0;
+}
+
+static int op_subscribe(struct dd_conn *c, const uint8_t *payload, uint32_t len) {
+	char pattern[REG_NAME_LEN];
+	uint8_t *p;
+	int i, n;
+
+	if(len == 0 || len >= REG_NAME_LEN)
+		return conn_error(c, DD_OP_SUBSCRIBE, DD_EINVAL);
+
+	memcpy(pattern, payload, len);
+	pattern[len] = '\0';
+
+	if((n = registry_match(registry, pattern, scratch_indices)) == 0)
+		return conn_error(c, DD_OP_SUBSCRIBE, DD_ENOENT);
+
+	if(c->filter == NULL) {
+		c->filter = calloc((registry->count + 7) / 8, 1);
+		c->queue = malloc(DD_SUB_QUEUE * sizeof(struct dd_event));
+		if(c->filter == NULL || c->queue == NULL)
+			return -1;
+	}
+
+	for(i = 0; i < n; i++)
+		c->filter[scratch_indices[i] / 8] |= 1 << (scratch_indices[i] % 8);
+
+	if((p = conn_reply(c, DD_OP_SUBSCRIBE, DD_OK, 4)) == NULL)
+		return -1;
+
+	dd_put32(p, n);
+	return 0;
+}
+
+static void conn_unsubscribe(struct dd_conn *c) {
+	free(c->filter);
+	free(c->queue);
+	c->filter = NULL;
+	c->queue = NULL;
+	c->q_head = c->q_len = 0;
+	c->dropped = 0;
+}
+
+static int op_unsubscribe(struct dd_conn *c) {
+	conn_unsubscribe(c);
+	return conn_error(c, DD_OP_UNSUBSCRIBE, DD_OK);
+}
+
+/* Executes one request frame
+ * Output:
+ *	0 on success, -1 if the connection has to be dropped
+ */
+static int conn_request(struct dd_conn *c, const struct dd_hdr *hdr, const uint8_t *payload) {
+	switch(hdr->op) {
+		case DD_OP_INFO:
+			return op_info(c);
+
+		case DD_OP_READ:
+			return op_read(c, payload, hdr->len);
+
+		case DD_OP_SNAPSHOT:
+			return op_snapshot(c);
+
+		case DD_OP_DIFF:
+			return op_diff(c);
+
+		case DD_OP_READ_BATCH:
+			return op_read_batch(c, payload, hdr->len);
+
+		case DD_OP_READ_SET:
+			return op_read_set(c, payload, hdr->len);
+
+		case DD_OP_SUBSCRIBE:
+			return op_subscribe(c, payload, hdr->len);
+
+		case DD_OP_UNSUBSCRIBE:
+			return op_unsubscribe(c);
+
+		case DD_OP_ROLLUP:
+			return op_rollup(c, payload, hdr->len);
+
+		default:
+			return conn_error(c, hdr->op, DD_EOP);
+	}
+}
+
+/* Executes the complete frames of the input buffer
+ * Output:
+ *	0 on success, -1 if the connection has to be dropped
+ */
+static int conn_process(struct dd_conn *c) {
+	size_t off = 0;
+	struct dd_hdr hdr;
+
+	while(c->in_len - off >= DD_HDR_SIZE) {
+		dd_get_hdr(c->in + off, &hdr);
+
+		if(hdr.magic != DD_MAGIC || hdr.len > DD_MAX_PAYLOAD)
+			return -1;
+
+		if(c->in_len - off < DD_HDR_SIZE + hdr.len)
+			break;
+
+		if(conn_request(c, &hdr, c->in + off + DD_HDR_SIZE) == -1)
+			return -1;
+
+		off += DD_HDR_SIZE + hdr.len;
+	}
+
+	memmove(c->in, c->in + off, c->in_len - off);
+	c->in_len -= off;
+
+	return 0;
+}
+
+static int conn_input(struct dd_conn *c) {
+	ssize_t n;
+
+	if(dd_reserve(&c->in, &c->in_size, c->in_len, DD_READ_CHUNK) == -1)
+		return -1;
+
+	n = read(c->fd, c->in + c->in_len, c->in_size - c->in_len);
+	if(n < 0)
+		return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+	if(n == 0)
+		return -1;
+
+	c->in_len += n;
+	return conn_process(c);
+}
+
+static int conn_output(struct dd_conn *c) {
+	ssize_t n;
+
+	while(c->out_off < c->out_len) {
+		n = send(c->fd, c->out + c->out_off, c->out_len - c->out_off, MSG_NOSIGNAL);
+		if(n < 0)
+			return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+		c->out_off += n;
+	}
+
+	c->out_off = c->out_len = 0;
+	return 0;
+}
+
+/*
+ * Moves the queued events of a subscriber to its output buffer, unless the
+ * subscriber is already behind on its socket
+ * Output:
+ *	0 on success, -1 if the connection has to be dropped
+ */
+static int conn_flush_events(struct dd_conn *c) {
+	uint8_t *p;
+	unsigned int i;
+
+	if(c->q_len == 0 && c->dropped == 0)
+		return 0;
+	if(c->out_len - c->out_off >= DD_EVENT_LIMIT)
+		return 0;
+
+	if(c->dropped > 0) {
+		if((p = conn_reply(c, DD_OP_DROPPED, DD_OK, 4)) == NULL)
+			return -1;
+		dd_put32(p, c->dropped);
+		c->dropped = 0;
+	}
+
+	if(c->q_len == 0)
+		return 0;
+
+	if((p = conn_reply(c, DD_OP_EVENT, DD_OK, 8 + 12 * c->q_len)) == NULL)
+		return -1;
+
+	dd_put32(p, samples);
+	dd_put32(p + 4, c->q_len);
+	p += 8;
+
+	for(i = 0; i < c->q_len; i++, p += 12) {
+		const struct dd_event *e = &c->queue[(c->q_head + i) % DD_SUB_QUEUE];
+
+		dd_put32(p, e->index);
+		dd_put32(p + 4, e->old);
+		dd_put32(p + 8, e->new);
+	}
+
+	c->q_head = c->q_len = 0;
+	return 0;
+}
+
+/* Takes one sample and queues the changes on the interested subscribers */
+static void daemon_sample(void) {
+	uint32_t *tmp;
+	int i, j;
+
+	plan_run(&snapshot_plan, sample_cur);
+	samples++;
+	if(rollups)
+		rollup_add(sample_cur);
+
+	// the first sample after a quiet period only sets the reference
+	for(i = 0; sample_valid && i < registry->count; i++) {
+		if(sample_cur[i] == sample_prev[i])
+			continue;
+
+		for(j = 0; j < num_conns; j++) {
+			struct dd_conn *c = &conns[j];
+			struct dd_event *e;
+
+			if(c->filter == NULL || !(c->filter[i / 8] & (1 << (i % 8))))
+				continue;
+
+			if(c->q_len == DD_SUB_QUEUE) {
+				c->dropped++;
+				continue;
+			}
+
+			e = &c->queue[(c->q_head + c->q_len++) % DD_SUB_QUEUE];
+			e->index = i;
+			e->old = sample_prev[i];
+			e->new = sample_cur[i];
+		}
+	}
+
+	tmp = sample_prev;
+	sample_prev = sample_cur;
+	sample_cur = tmp;
+	sample_valid = 1;
+}
+
+static void conn_close(int i) {
+	struct dd_conn *c = &conns[i];
+
+	close(c->fd);
+	conn_unsubscribe(c);
+	free(c->in);
+	free(c->out);
+	free(c->baseline);
+	free(c->set_indices);
+	plan_free(&c->set_plan);
+
+	conns[i] = conns[--num_conns];
+}
+
+static void daemon_accept(int lfd) {
+	int fd;
+
+	while((fd = accept(lfd, NULL, NULL)) >= 0) {
+		if(num_conns == DD_MAX_CLIENTS) {
+			fprintf(stderr, "devicedbg: too many clients\n");
+			close(fd);
+			continue;
+		}
+
+		fcntl(fd, F_SETFL, O_NONBLOCK);
+		fcntl(fd, F_SETFD, FD_CLOEXEC);
+		net_nodelay(fd);
+		memset(&conns[num_conns], 0, sizeof(struct dd_conn));
+		conns[num_conns++].fd = fd;
+	}
+}
+
+/*
+ * Runs the daemon until SIGINT or SIGTERM
+ * Input:
+ *	const char *endpoint		- Unix socket path or TCP address
+ *	const struct reg_registry *rr	- registry of the detected family
+ *	int interval_ms			- sampling period for the subscribers
+ *	int num_agents			- consecutive endpoints to listen on
+ *	const char *retention		- rollups kept (see rollup_init()), or NULL
+ *	const char *rollup_path		- file the rollups are saved to, or NULL
+ *
+ * Output:
+ *	exit status of the program
+ */
+int run_daemon(const char *endpoint, const struct reg_registry *rr, int interval_ms,
+	       int num_agents, const char *retention, const char *rollup_path) {
+	static struct pollfd pfds[DD_MAX_LISTEN + DD_MAX_CLIENTS];
+	static int lfds[DD_MAX_LISTEN];
+	char name[256];
+	struct sigaction sa;
+	uint64_t now, next_sample = 0;
+	int i, n, subscribers, timeout;
+
+	if(num_agents < 1 || num_agents > DD_MAX_LISTEN) {
+		fprintf(stderr, "devicedbg: 1 to %d agents per process\n", DD_MAX_LISTEN);
+		return 1;
+	}
+
+	registry = rr;
+	if((scratch = malloc(rr->count * sizeof(uint32_t))) == NULL) FATAL;
+	if((scratch_indices = malloc(rr->count * sizeof(int))) == NULL) FATAL;
+	if((sample_prev = malloc(rr->count * sizeof(uint32_t))) == NULL) FATAL;
+	if((sample_cur = malloc(rr->count * sizeof(uint32_t))) == NULL) FATAL;
+
+	// map every page up front, requests only hit the mapping cache
+	if(plan_build_all(&snapshot_plan, rr) == -1) FATAL;
+	plan_run(&snapshot_plan, scratch);
+	printf("%d registers, %d pages mapped, table hash %08X\n",
+	       rr->count, mem_num_maps(), rr->hash);
+
+	if(retention != NULL) {
+		if(rollup_init(rr, retention, rollup_path) == -1)
+			return 1;
+		rollups = 1;
+	}
+
+	for(i = 0; i < num_agents; i++) {
+		net_endpoint_nth(name, sizeof(name), endpoint, i);
+		if((lfds[i] = net_listen(name)) == -1) FATAL;
+	}
+	printf("listening on %s%s\n", endpoint, num_agents > 1 ? " and following" : "");
+	fflush(stdout);
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = daemon_signal;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	while(!daemon_quit) {
+		subscribers = 0;
+		for(i = 0; i < num_conns; i++)
+			subscribers += conns[i].filter != NULL;
+
+		// sample only while somebody listens or rollups are kept
+		timeout = -1;
+		if(subscribers == 0 && !rollups)
+			sample_valid = 0;
+		else {
+			now = now_ns();
+			if(!sample_valid || now >= next_sample) {
+				daemon_sample();
+				next_sample += interval_ms * 1000000ULL;
+				if(next_sample <= now)
+					next_sample = now + interval_ms * 1000000ULL;
+
+				for(i = num_conns - 1; i >= 0; i--) {
+					if(conns[i].filter != NULL && conn_flush_events(&conns[i]) == -1)
+						conn_close(i);
+				}
+			}
+			timeout = (next_sample - now + 999999) / 1000000;
+		}
+
+		for(i = 0; i < num_agents; i++) {
+			pfds[i].fd = lfds[i];
+			pfds[i].events = POLLIN;
+		}
+
+		for(i = 0; i < num_conns; i++) {
+			struct dd_conn *c = &conns[i];
+			struct pollfd *pfd = &pfds[num_agents + i];
+
+			pfd->fd = c->fd;
+			pfd->events = 0;
+			if(c->out_len - c->out_off < DD_OUT_LIMIT)
+				pfd->events |= POLLIN;
+			if(c->out_off < c->out_len)
+				pfd->events |= POLLOUT;
+		}
+
+		n = num_conns;
+		if(poll(pfds, num_agents + n, timeout) == -1) {
+			if(errno == EINTR)
+				continue;
+			FATAL;
+		}
+
+		// walk backwards, conn_close() moves the last connection into the hole
+		for(i = n - 1; i >= 0; i--) {
+			struct dd_conn *c = &conns[i];
+			short ev = pfds[num_agents + i].revents;
+			int err = 0;
+
+			if(ev & (POLLERR | POLLNVAL))
+				err = 1;
+			if(!err && (ev & (POLLIN | POLLHUP)))
+				err = conn_input(c) == -1;
+			if(!err && c->out_off < c->out_len)
+				err = conn_output(c) == -1;
+			if(!err && c->filter != NULL)
+				err = conn_flush_events(c) == -1;
+
+			if(err)
+				conn_close(i);
+		}
+
+		for(i = 0; i < num_agents; i++) {
+			if(pfds[i].revents & POLLIN)
+				daemon_accept(lfds[i]);
+		}
+	}
+
+	while(num_conns > 0)
+		conn_close(num_conns - 1);
+
+	for(i = 0; i < num_agents; i++) {
+		close(lfds[i]);
+		net_endpoint_nth(name, sizeof(name), endpoint, i);
+		net_unlink(name);
+	}
+	if(rollups)
+		rollup_close();
+	plan_free(&snapshot_plan);
+	free(scratch);
+	free(scratch_indices);
+	free(sample_prev);
+	free(sample_cur);
+	mem_close();
+
+	return 0;
+}
@@ -0,0 +1,715 @@
+/*
+ * desc.c : register descriptions loaded from text files
+ *
+ * A description replaces the built-in register tables of one family, so a
+ * new SoC revision only needs a new file. It is a text file of one record
+ * per line, fields separated by commas:
+ *
+ *	family,AM335x			family the description is for, first
+ *	section,UART[,0x1000]		one of section_names[], and the size of
+ *					its window, 4 KiB by default
+ *	instance,UART1,0x48022000	instance of the last section
+ *	clock,0x44E0006C,0x10000	module state of the last instance: its
+ *					register, and the bits set in it while
+ *					the module is not accessible
+ *	register,0x14,UART_LSR/-[,clear] register of the last section, and
+ *					the side effects of reading it: clear
+ *					(bits cleared by the read), fifo (the
+ *					read pops an entry) or write (write-
+ *					only); none for the others
+ *	field,TX_FIFO_E,5,1		name, shift, width, of the last register
+ *	enum,3,8BITS			named value of the last field
+ *	mask,UART*.LSR/-,0xFFFFFFFF	default volatile bits (struct reg_mask)
+ *
+ * Empty lines and lines starting with '#' are ignored. Offsets are 32 bit
+ * aligned, inside the window of their section and unique in it.
+ *
+ * The built-in tables are generated from the descriptions of the families
+ * (omap44x.desc, am335x.desc, omap35x.desc) by regtab.awk; -W writes the
+ * tables in use back in this format.
+ *
+ * Parsing happens once. The description is compiled into a binary image
+ * made of fixed size records referring to each other and to a string pool by
+ * index, saved next to the text file as "<file>.cache" with the FNV-1a hash
+ * of the text. Later runs hash the text, map the cache when the hash
+ * matches, and only turn the indices into the pointers of struct soc_tables;
+ * the strings are used in place. Register names are stored front-coded, as in
+ * the built-in tables (see reg_name()). The cache is in host byte order.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "devicedbg.h"
+
+#define DESC_MAGIC	0x43444444	/* "DDDC" */
+#define DESC_VERSION	4
+#define DESC_LINE	512
+
+struct desc_hdr {
+	uint32_t magic, version;
+	uint32_t text_hash;			/* FNV-1a of the description text */
+	uint32_t type;				/* processor type */
+	uint32_t num_sections, num_regs, num_instances, num_fields, num_enums, num_masks;
+	uint32_t strings;			/* bytes of the string pool */
+};
+
+struct desc_section {
+	uint32_t id, reg, num_regs, instance, num_instances;
+};
+
+struct desc_reg {
+	uint32_t offset, name, field, num_fields, access;
+};
+
+struct desc_instance {
+	uint32_t name, base, clock, clock_off;
+};
+
+struct desc_field {
+	uint32_t name, shift, width, value, num_values;
+};
+
+struct desc_enum {
+	uint32_t value, name;
+};
+
+struct desc_mask {
+	uint32_t pattern, ignore;
+};
+
+/* description being compiled */
+struct desc_image {
+	struct desc_hdr hdr;
+	struct desc_section *sections;
+	struct desc_reg *regs;
+	struct desc_instance *instances;
+	struct desc_field *fields;
+	struct desc_enum *enums;
+	struct desc_mask *masks;
+	char *strings;
+	size_t strings_size;
+};
+
+/* register attributes, indexed by REG_READ_SAFE... */
+static const char *const desc_access[] = { "", "clear", "fifo", "write" };
+
+/* Grows an array of the image by one element and returns it, zeroed */
+static void *desc_grow(void *array, uint32_t *count, size_t size) {
+	char *p;
+
+	// doubles at every power of two
+	if((*count & (*count - 1)) == 0 &&
+	   (array = realloc(array, (*count ? 2 * *count : 1) * size)) == NULL) FATAL;
+
+	p = (char *) array + (*count)++ * size;
+	memset(p, 0, size);
+	return array;
+}
+
+#define DESC_ADD(img, array, counter) \
+	((img)->array = desc_grow((img)->array, &(img)->hdr.counter, sizeof(*(img)->array)), \
+	 &(img)->array[(img)->hdr.counter - 1])
+
+static uint32_t desc_bytes(struct desc_image *img, const char *s, size_t len) {
+	uint32_t off = img->hdr.strings;
+
+	while(img->hdr.strings + len > img->strings_size) {
+		img->strings_size = img->strings_size ? 2 * img->strings_size : 4096;
+		if((img->strings = realloc(img->strings, img->strings_size)) == NULL) FATAL;
+	}
+
+	memcpy(img->strings + off, s, len);
+	img->hdr.strings += len;
+	return off;
+}
+
+static uint32_t desc_string(struct desc_image *img, const char *s) {
+	return desc_bytes(img, s, strlen(s) + 1);
+}
+
+/* Adds the name of the n-th register of a section, front-coded against the previous one */
+static uint32_t desc_reg_name(struct desc_image *img, char *prev, uint32_t n, const char *name) {
+	char coded[REG_NAME_LEN + 1];
+	size_t len = strlen(name), p = 0;
+
+	if(n % REG_NAME_RESTART != 0)
+		while(prev[p] != '\0' && prev[p] == name[p])
+			p++;
+
+	coded[0] = p;
+	memcpy(coded + 1, name + p, len - p + 1);
+	memcpy(prev, name, len + 1);
+	return desc_bytes(img, coded, len - p + 2);
+}
+
+static void desc_free_image(struct desc_image *img) {
+	free(img->sections);
+	free(img->regs);
+	free(img->instances);
+	free(img->fields);
+	free(img->enums);
+	free(img->masks);
+	free(img->strings);
+}
+
+/* Splits a line on commas, trailing blanks of the line removed
+ * Output:
+ *	number of fields
+ */
+static int desc_split(char *line, char **argv, int max) {
+	size_t len = strlen(line);
+	int n = 0;
+
+	while(len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r' ||
+			  line[len - 1] == ' ' || line[len - 1] == '\t'))
+		line[--len] = '\0';
+
+	argv[n++] = line;
+	while(n < max && (line = strchr(line, ',')) != NULL) {
+		*line++ = '\0';
+		argv[n++] = line;
+	}
+
+	return n;
+}
+
+static int desc_number(const char *s, uint32_t *v) {
+	char *end;
+	unsigned long long n;
+
+	errno = 0;
+	n = strtoull(s, &end, 0);
+	if(end == s || *end != '\0' || errno != 0 || n > UINT32_MAX)
+		return -1;
+
+	*v = n;
+	return 0;
+}
+
+/*
+ * Compiles a description text
+ * Input:
+ *	const char *path	- file name, for the messages
+ *	char *text, size_t size	- whole text, modified
+ *	struct desc_image *img	- receives the image
+ *
+ * Output:
+ *	0 on success, -1 on a syntax error, the reason is printed
+ */
+static int desc_parse(const char *path, char *text, size_t size, struct desc_image *img) {
+	const struct soc_family *family = NULL;
+	struct desc_section *section = NULL;
+	struct desc_reg *reg = NULL;
+	struct desc_field *field = NULL;
+	struct desc_instance *instance = NULL;
+	struct desc_enum *value;
+	struct desc_mask *mask;
+	char *line, *next, *argv[4], prev[REG_NAME_LEN];
+	const char *why = NULL;
+	int lineno = 0, argc, i;
+	uint32_t a, b, r, window = 0;
+
+	for(line = text; line < text + size && why == NULL; line = next) {
+		if((next = memchr(line, '\n', text + size - line)) != NULL)
+			*next++ = '\0';
+		else
+			next = text + size;
+		lineno++;
+
+		if(line[0] == '#' || line[strspn(line, " \t\r")] == '\0')
+			continue;
+
+		argc = desc_split(line, argv, 4);
+
+		if(strcmp(argv[0], "family") == 0 && argc == 2) {
+			if(family != NULL)
+				why = "one family per description";
+			else if((family = find_family(argv[1])) == NULL)
+				why = "unknown family";
+			else
+				img->hdr.type = family->type;
+		}
+		else if(family == NULL)
+			why = "the family comes first";
+		else if(strcmp(argv[0], "section") == 0 && (argc == 2 || argc == 3)) {
+			for(i = 0; i < NUM_SECTIONS && strcasecmp(section_names[i], argv[1]) != 0; i++)
+				;
+			window = MAP_SIZE;
+			if(i == NUM_SECTIONS || (argc == 3 && desc_number(argv[2], &window) == -1)) {
+				why = i == NUM_SECTIONS ? "unknown section" : "bad window";
+				continue;
+			}
+			section = DESC_ADD(img, sections, num_sections);
+			section->id = i;
+			section->reg = img->hdr.num_regs;
+			section->instance = img->hdr.num_instances;
+			instance = NULL;
+			reg = NULL;
+			field = NULL;
+		}
+		else if(strcmp(argv[0], "instance") == 0 && argc == 3) {
+			if(section == NULL || desc_number(argv[2], &a) == -1) {
+				why = section ? "bad base address" : "instance outside a section";
+				continue;
+			}
+			instance = DESC_ADD(img, instances, num_instances);
+			instance->name = desc_string(img, argv[1]);
+			instance->base = a;
+			section->num_instances++;
+		}
+		else if(strcmp(argv[0], "clock") == 0 && argc == 3) {
+			if(instance == NULL || desc_number(argv[1], &a) == -1 || (a & 3) != 0 ||
+			   desc_number(argv[2], &b) == -1 || b == 0) {
+				why = instance ? "bad clock register or bits" : "clock outside an instance";
+				continue;
+			}
+			instance->clock = a;
+			instance->clock_off = b;
+		}
+		else if(strcmp(argv[0], "register") == 0 && (argc == 3 || argc == 4)) {
+			if(section == NULL || desc_number(argv[1], &a) == -1) {
+				why = section ? "bad offset" : "register outside a section";
+				continue;
+			}
+			for(b = 1; argc == 4 && b < ARRAY_SIZE(const char *, desc_access) &&
+			    strcmp(argv[3], desc_access[b]) != 0; b++)
+				;
+			if(argc == 4 && b == ARRAY_SIZE(const char *, desc_access)) {
+				why = "unknown register attribute";
+				continue;
+			}
+			// the checks regtab.awk compiles into the built-in tables
+			for(r = section->reg; r < img->hdr.num_regs && img->regs[r].offset != a; r++)
+				;
+			if((a & 3) != 0 || (uint64_t) a + 4 > window || r < img->hdr.num_regs) {
+				why = r < img->hdr.num_regs ? "offset of another register" :
+				      "offset unaligned or outside the window of the section";
+				continue;
+			}
+			if(strlen(argv[2]) >= REG_NAME_LEN) {
+				why = "register name too long";
+				continue;
+			}
+			reg = DESC_ADD(img, regs, num_regs);
+			reg->offset = a;
+			reg->name = desc_reg_name(img, prev, section->num_regs, argv[2]);
+			reg->field = img->hdr.num_fields;
+			reg->access = argc == 4 ? b : REG_READ_SAFE;
+			section->num_regs++;
+			field = NULL;
+		}
+		else if(strcmp(argv[0], "field") == 0 && argc == 4) {
+			if(reg == NULL || desc_number(argv[2], &a) == -1 || desc_number(argv[3], &b) == -1 ||
+			   b == 0 || a + b > 32) {
+				why = reg ? "bad field position" : "field outside a register";
+				continue;
+			}
+			field = DESC_ADD(img, fields, num_fields);
+			field->name = desc_string(img, argv[1]);
+			field->shift = a;
+			field->width = b;
+			field->value = img->hdr.num_enums;
+			reg->num_fields++;
+		}
+		else if(strcmp(argv[0], "enum") == 0 && argc == 3) {
+			if(field == NULL || desc_number(argv[1], &a) == -1) {
+				why = field ? "bad value" : "enum outside a field";
+				continue;
+			}
+			value = DESC_ADD(img, enums, num_enums);
+			value->value = a;
+			value->name = desc_string(img, argv[2]);
+			field->num_values++;
+		}
+		else if(strcmp(argv[0], "mask") == 0 && argc == 3) {
+			if(desc_number(argv[2], &a) == -1) {
+				why = "bad mask";
+				continue;
+			}
+			mask = DESC_ADD(img, masks, num_masks);
+			mask->pattern = desc_string(img, argv[1]);
+			mask->ignore = a;
+		}
+		else
+			why = "unknown record";
+	}
+
+	if(why == NULL && family == NULL) {
+		why = "no family";
+		lineno = 0;
+	}
+
+	if(why != NULL) {
+		fprintf(stderr, "devicedbg: %s:%d: %s\n", path, lineno, why);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Writes the compiled image next to the description, replacing it only once complete */
+static void desc_save(const char *cache, const struct desc_image *img) {
+	char tmp[4096];
+	FILE *f;
+	int ok;
+
+	snprintf(tmp, sizeof(tmp), "%s.tmp", cache);
+	if((f = fopen(tmp, "w")) == NULL) {
+		fprintf(stderr, "devicedbg: %s: %s, description not cached\n", tmp, strerror(errno));
+		return;
+	}
+
+	ok = fwrite(&img->hdr, sizeof(img->hdr), 1, f) == 1 &&
+	     fwrite(img->sections, sizeof(*img->sections), img->hdr.num_sections, f) == img->hdr.num_sections &&
+	     fwrite(img->regs, sizeof(*img->regs), img->hdr.num_regs, f) == img->hdr.num_regs &&
+	     fwrite(img->instances, sizeof(*img->instances), img->hdr.num_instances, f) == img->hdr.num_instances &&
+	     fwrite(img->fields, sizeof(*img->fields), img->hdr.num_fields, f) == img->hdr.num_fields &&
+	     fwrite(img->enums, sizeof(*img->enums), img->hdr.num_enums, f) == img->hdr.num_enums &&
+	     fwrite(img->masks, sizeof(*img->masks), img->hdr.num_masks, f) == img->hdr.num_masks &&
+	     fwrite(img->strings, 1, img->hdr.strings, f) == img->hdr.strings;
+
+	if(fclose(f) == EOF || !ok || rename(tmp, cache) == -1) {
+		fprintf(stderr, "devicedbg: %s: %s, description not cached\n", cache, strerror(errno));
+		unlink(tmp);
+	}
+}
+
+/* Size of an image from its header, 0 if the counts are absurd */
+static size_t desc_image_size(const struct desc_hdr *hdr) {
+	uint64_t size = sizeof(*hdr) +
+		(uint64_t) hdr->num_sections * sizeof(struct desc_section) +
+		(uint64_t) hdr->num_regs * sizeof(struct desc_reg) +
+		(uint64_t) hdr->num_instances * sizeof(struct desc_instance) +
+		(uint64_t) hdr->num_fields * sizeof(struct desc_field) +
+		(uint64_t) hdr->num_enums * sizeof(struct desc_enum) +
+		(uint64_t) hdr->num_masks * sizeof(struct desc_mask) + hdr->strings;
+
+	return size > SIZE_MAX ? 0 : size;
+}
+
+/* Points the image arrays into a contiguous image, as written by desc_save() */
+static void desc_view(struct desc_image *img, const void *base) {
+	const char *p = (const char *) base + sizeof(struct desc_hdr);
+
+	memcpy(&img->hdr, base, sizeof(img->hdr));
+	img->sections = (struct desc_section *) p;
+	p += img->hdr.num_sections * sizeof(struct desc_section);
+	img->regs = (struct desc_reg *) p;
+	p += img->hdr.num_regs * sizeof(struct desc_reg);
+	img->instances = (struct desc_instance *) p;
+	p += img->hdr.num_instances * sizeof(struct desc_instance);
+	img->fields = (struct desc_field *) p;
+	p += img->hdr.num_fields * sizeof(struct desc_field);
+	img->enums = (struct desc_enum *) p;
+	p += img->hdr.num_enums * sizeof(struct desc_enum);
+	img->masks = (struct desc_mask *) p;
+	p += img->hdr.num_masks * sizeof(struct desc_mask);
+	img->strings = (char *) p;
+}
+
+/*
+ * Turns an image into register tables, the strings stay in the image
+ * Output:
+ *	tables, or NULL if the image refers outside itself
+ */
+static struct soc_tables *desc_tables(const struct desc_image *img) {
+	const struct desc_hdr *h = &img->hdr;
+	struct soc_tables *tables;
+	struct reg_section *sections;
+	struct reg_info *regs;
+	struct reg_instance *instances;
+	struct reg_field *fields;
+	struct reg_enum *enums;
+	struct reg_mask *masks;
+	uint32_t s, r, f, e, nf = 0, ne = 0;
+
+	// the string pool ends with a NUL, any index below its size is a string
+	if(h->strings == 0 || img->strings[h->strings - 1] != '\0')
+		return NULL;
+#define DESC_STR(i)	((i) < h->strings ? img->strings + (i) : NULL)
+
+	tables = calloc(1, sizeof(*tables));
+	sections = calloc(h->num_sections + 1, sizeof(*sections));
+	regs = calloc(h->num_regs + 1, sizeof(*regs));
+	instances = calloc(h->num_instances + 1, sizeof(*instances));
+	fields = calloc(h->num_fields + h->num_regs + 1, sizeof(*fields));
+	enums = calloc(h->num_enums + h->num_fields + 1, sizeof(*enums));
+	masks = calloc(h->num_masks + 1, sizeof(*masks));
+	if(tables == NULL || sections == NULL || regs == NULL || instances == NULL ||
+	   fields == NULL || enums == NULL || masks == NULL) FATAL;
+
+	for(s = 0; s < h->num_sections; s++) {
+		const struct desc_section *ds = &img->sections[s];
+
+		if(ds->id >= NUM_SECTIONS || ds->reg + (uint64_t) ds->num_regs > h->num_regs ||
+		   ds->instance + (uint64_t) ds->num_instances > h->num_instances)
+			goto bad;
+
+		sections[s].id = ds->id;
+		sections[s].regs = regs + ds->reg;
+		sections[s].num_regs = ds->num_regs;
+		sections[s].instances = instances + ds->instance;
+		sections[s].num_instances = ds->num_instances;
+	}
+
+	for(r = 0; r < h->num_instances; r++) {
+		if((instances[r].name = DESC_STR(img->instances[r].name)) == NULL)
+			goto bad;
+		instances[r].base = img->instances[r].base;
+		instances[r].clock = img->instances[r].clock;
+		instances[r].clock_off = img->instances[r].clock_off;
+	}
+
+	// fields and enums are copied with a terminator after each list
+	for(r = 0; r < h->num_regs; r++) {
+		const struct desc_reg *dr = &img->regs[r];
+
+		// a register name is a prefix length then a string
+		if((regs[r].name = DESC_STR(dr->name)) == NULL || dr->name + 1ULL >= h->strings ||
+		   dr->field + (uint64_t) dr->num_fields > h->num_fields ||
+		   dr->access > REG_WRITE_ONLY)
+			goto bad;
+		regs[r].offset = dr->offset;
+		regs[r].access = dr->access;
+		if(dr->num_fields == 0)
+			continue;
+
+		regs[r].fields = fields + nf;
+		for(f = dr->field; f < dr->field + dr->num_fields; f++, nf++) {
+			const struct desc_field *df = &img->fields[f];
+
+			if((fields[nf].name = DESC_STR(df->name)) == NULL || df->width == 0 ||
+			   df->shift + df->width > 32 ||
+			   df->value + (uint64_t) df->num_values > h->num_enums)
+				goto bad;
+			fields[nf].shift = df->shift;
+			fields[nf].width = df->width;
+			if(df->num_values == 0)
+				continue;
+
+			fields[nf].values = enums + ne;
+			for(e = df->value; e < df->value + df->num_values; e++, ne++) {
+				if((enums[ne].name = DESC_STR(img->enums[e].name)) == NULL)
+					goto bad;
+				enums[ne].value = img->enums[e].value;
+			}
+			ne++;
+		}
+		nf++;
+	}
+
+	// the front-coded names decode within REG_NAME_LEN bytes, see reg_name()
+	for(s = 0; s < h->num_sections; s++) {
+		size_t len = 0;
+
+		for(r = 0; r < (uint32_t) sections[s].num_regs; r++) {
+			const char *name = sections[s].regs[r].name;
+
+			if((unsigned char) name[0] > (r % REG_NAME_RESTART ? len : 0) ||
+			   (len = (unsigned char) name[0] + strlen(name + 1)) >= REG_NAME_LEN)
+				goto bad;
+		}
+	}
+
+	for(r = 0; r < h->num_masks; r++) {
+		if((masks[r].pattern = DESC_STR(img->masks[r].pattern)) == NULL)
+			goto bad;
+		masks[r].ignore = img->masks[r].ignore;
+	}
+#undef DESC_STR
+
+	tables->sections = sections;
+	tables->num_sections = h->num_sections;
+	tables->masks = masks;
+	tables->num_masks = h->num_masks;
+	return tables;
+
+bad:
+	free(tables);
+	free(sections);
+	free(regs);
+	free(instances);
+	free(fields);
+	free(enums);
+	free(masks);
+	return NULL;
+}
+
+/* Maps the cache of a description if it was compiled from the same text
+ * Output:
+ *	image mapping or NULL
+ */
+static const void *desc_map_cache(const char *cache, uint32_t text_hash) {
+	const struct desc_hdr *hdr;
+	struct stat st;
+	void *p;
+	int fd;
+
+	if((fd = open(cache, O_RDONLY | O_CLOEXEC)) == -1)
+		return NULL;
+
+	if(fstat(fd, &st) == -1 || st.st_size < sizeof(*hdr) ||
+	   (p = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == (void *) -1) {
+		close(fd);
+		return NULL;
+	}
+	close(fd);
+
+	hdr = p;
+	if(hdr->magic != DESC_MAGIC || hdr->version != DESC_VERSION ||
+	   hdr->text_hash != text_hash || desc_image_size(hdr) != st.st_size) {
+		munmap(p, st.st_size);
+		return NULL;
+	}
+
+	return p;
+}
+
+/*
+ * Loads a description file, its tables replace the built-in ones of its family
+ * Input:
+ *	const char *path	- description text, its cache is "<path>.cache"
+ *
+ * Output:
+ *	0 on success, -1 on error, the reason is printed
+ */
+int desc_load(const char *path) {
+	struct desc_image img;
+	struct soc_tables *tables;
+	char cache[4096], *text;
+	const void *image;
+	uint32_t hash;
+	struct stat st;
+	uint64_t start = now_ns();
+	int fd, cached = 1;
+
+	if((fd = open(path, O_RDONLY | O_CLOEXEC)) == -1 || fstat(fd, &st) == -1) {
+		fprintf(stderr, "devicedbg: %s: %s\n", path, strerror(errno));
+		if(fd != -1)
+			close(fd);
+		return -1;
+	}
+
+	// one more byte, the parser may need a final NUL
+	if((text = malloc(st.st_size + 1)) == NULL) FATAL;
+	if(read(fd, text, st.st_size) != st.st_size) {
+		fprintf(stderr, "devicedbg: %s: short read\n", path);
+		close(fd);
+		free(text);
+		return -1;
+	}
+	close(fd);
+	text[st.st_size] = '\0';
+
+	hash = fnv1a(2166136261U, text, st.st_size);
+	snprintf(cache, sizeof(cache), "%s.cache", path);
+
+	// the image, mapped or compiled, stays for the whole run: the strings live in it
+	if((image = desc_map_cache(cache, hash)) == NULL) {
+		cached = 0;
+		memset(&img, 0, sizeof(img));
+		if(desc_parse(path, text, st.st_size, &img) == -1) {
+			desc_free_image(&img);
+			free(text);
+			return -1;
+		}
+		img.hdr.magic = DESC_MAGIC;
+		img.hdr.version = DESC_VERSION;
+		img.hdr.text_hash = hash;
+		desc_save(cache, &img);
+
+		if((image = desc_map_cache(cache, hash)) == NULL) {
+			// no cache could be written, keep the compiled arrays
+			tables = desc_tables(&img);
+			goto done;
+		}
+		desc_free_image(&img);
+	}
+
+	desc_view(&img, image);
+	tables = desc_tables(&img);
+
+done:
+	free(text);
+	if(tables == NULL || find_family_type(img.hdr.type) == NULL) {
+		fprintf(stderr, "devicedbg: %s: inconsistent description\n", cached ? cache : path);
+		return -1;
+	}
+
+	family_set_tables(find_family_type(img.hdr.type), tables);
+	fprintf(stderr, "devicedbg: %s: %s description of %s, %u registers, %.1f ms\n", path,
+		cached ? "cached" : "compiled", find_family_type(img.hdr.type)->name,
+		img.hdr.num_regs, (now_ns() - start) / 1e6);
+	return 0;
+}
+
+/*
+ * Writes the register tables of a family as a description file
+ * Input:
+ *	const struct soc_family *family	- family, its loaded or built-in tables
+ *	const char *path		- file to write
+ *
+ * Output:
+ *	exit status of the program
+ */
+int desc_export(const struct soc_family *family, const char *path) {
+	const struct soc_tables *tables = family_tables(family);
+	const struct reg_field *f;
+	const struct reg_enum *e;
+	char name[REG_NAME_LEN];
+	int s, i;
+	FILE *fp;
+
+	if((fp = fopen(path, "w")) == NULL) {
+		fprintf(stderr, "devicedbg: %s: %s\n", path, strerror(errno));
+		return 1;
+	}
+
+	fprintf(fp, "# devicedbg register description\nfamily,%s\n", family->name);
+
+	for(s = 0; s < tables->num_sections; s++) {
+		const struct reg_section *section = &tables->sections[s];
+
+		fprintf(fp, "\nsection,%s\n", section_names[section->id]);
+		for(i = 0; i < section->num_instances; i++) {
+			fprintf(fp, "instance,%s,0x%08lX\n", section->instances[i].name,
+				section->instances[i].base);
+			if(section->instances[i].clock != 0)
+				fprintf(fp, "clock,0x%08lX,0x%X\n", section->instances[i].clock,
+					section->instances[i].clock_off);
+		}
+
+		for(i = 0; i < section->num_regs; i++) {
+			fprintf(fp, "register,0x%03lX,%s%s%s\n", section->regs[i].offset,
+				reg_name(section->regs, i, name), section->regs[i].access ? "," : "",
+				desc_access[section->regs[i].access]);
+
+			for(f = section->regs[i].fields; f != NULL && f->name != NULL; f++) {
+				fprintf(fp, "field,%s,%u,%u\n", f->name, f->shift, f->width);
+				for(e = f->values; e != NULL && e->name != NULL; e++)
+					fprintf(fp, "enum,%u,%s\n", e->value, e->name);
+			}
+		}
+	}
+
+	fprintf(fp, "\n");
+	for(i = 0; i < tables->num_masks; i++)
+		fprintf(fp, "mask,%s,0x%08X\n", tables->masks[i].pattern, tables->masks[i].ignore);
+
+	if(fclose(fp) == EOF) {
+		fprintf(stderr, "devicedbg: %s: %s\n", path, strerror(errno));
+		return 1;
+	}
+
+	printf("%s tables written to %s\n", family->name, path);
+	return 0;
+}
@@ -26,12 +26,13 @@
  */
 
 /* Note:
- * If you encounter 'bus error' while reading the contents then,
+ * Reading a module whose clocks are gated raises a bus error. It is caught
+ * (mem_guard() in mem.c), the module is reported as not available and is not
+ * read again during the same boot (avail.c). To read the unused modules too,
  * recompile your linux kernel with the configuration setting
  *	CONFIG_OMAP_RESET_CLOCKS = n
- * This option do not reset the inactive clocks so that you have the access to 
- * the unused modules also.
- */ 
+ * This option do not reset the inactive clocks.
+ */
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -48,1038 +49,323 @@
 #include "devicedbg.h"
 
 /*
- * Main Routine for the program
+ * Reads the register contents from the memory
+ * Input:
+ *	struct reg_info rinfo[] -	structure having the register offset, name ,etc.
+ *	int num_regs		-	number of registers contained in the structure
+ *	unsigned long base	-	base address for the memory location to be read
+ *	uint32_t *values	-	receives the register values, may be NULL
+ *
+ * Output:
+ *	Register values are shown
  */
-int main(int argc, char **argv) {
-	int num_regs = 0;
-	int choice = 0;
+void show_registers(const struct reg_info rinfo[], int num_regs, unsigned long base,
+		    uint32_t *values) {
+	int i=0;
+	void *virt_addr;
+	uint32_t read_result;
+	unsigned long target;
+	char fields[256], name[REG_NAME_LEN];
+
+	printf("Base %lx\n",base);
+	printf("No of registers: %d\n", num_regs);
+
+	/* pages are mapped on first use, base need not be page aligned */
+	printf("Memory mapped at address %p.\n", mem_map(base));
+
+	for(i=0; i < num_regs; i++) {
+		target = base + rinfo[i].offset;
+		virt_addr = mem_map(target);
+
+		// FIFOs and status registers cleared by a read are left to the driver
+		if(!plan_readable(&rinfo[i])) {
+			printf("REGISTER NAME: %s \t\tnot read at address 0x%lX, %s\n",
+			       reg_name(rinfo, i, name), target, rinfo[i].access == REG_WRITE_ONLY ?
+			       "write-only" : "side effects on read (-X)");
+			if(values != NULL)
+				values[i] = 0;
+			continue;
+		}
 
-	if(argc < 2) {
-		fprintf(stderr, "Usage:\t%s { reg }\n"
-			"reg: desired register selection :[0]DCAN,[1]GPIO,[2]I2C,[3]LCD,[4]MCASP/MCBSP,[5]MCSPI,[6]MMCSD,[7]RTC,[8]TIMER,[9]TSC,[10]UART,[11]USB,[12]WDT,[13]PRODUT_ID,[14]LCD_CONTROLLER;\n",argv[0]);
-		exit(1);
+		// the module is not clocked, its other registers fault as well
+		if(mem_try_read32(target, &read_result) == -1) {
+			printf("REGISTER NAME: %s \t\tbus error at address 0x%lX, module not available\n",
+			       reg_name(rinfo, i, name), target);
+			if(values != NULL)
+				memset(values + i, 0, (num_regs - i) * sizeof(uint32_t));
+			return;
+		}
+		if(values != NULL)
+			values[i] = read_result;
+
+		reg_decode(&rinfo[i], read_result, fields, sizeof(fields));
+		printf("REGISTER NAME: %s \t\tValue at address 0x%lX \t offset 0x%lX \t (%p) \t: 0x%X%s\n",reg_name(rinfo, i, name),target,rinfo[i].offset ,virt_addr, read_result, fields);
 	}
+}
 
-        int n = atoi(argv[1]);
-	int processor = read_processor();	// which processor we are working on
+/*
+ * Shows a register section, asking for the instance if there are several
+ * Input:
+ *	const struct reg_section *section - section of the detected family
+ */
+static void show_section(const struct reg_section *section) {
+	const struct reg_instance *instance;
+	int choice = 1, i;
+
+	printf("\n%s Registers:\n", section_names[section->id]);
+
+	if(section->num_instances > 1) {
+		printf("Which one of the %d %s's?? [", section->num_instances,
+		       section_names[section->id]);
+		for(i = 0; i < section->num_instances; i++)
+			printf(i ? ",%s" : "%s", section->instances[i].name);
+		printf("] (1-%d):\n", section->num_instances);
+
+		if(scanf("%d",&choice) != 1 || choice < 1 || choice > section->num_instances) {
+			printf("Wrong choice\n");
+			return;
+		}
+	}
 
-	switch(processor) {
-#ifdef _OMAP4_
-		case OMAP4:
-		switch(n) {
-			case PRODUCT_ID:
-				// base 0x4A002000
-				num_regs = ARRAY_SIZE(struct reg_info, omap44x_product_id_registers);
-				printf("\n--------------Product ID Registers-----------------:\n");
-				show_registers(omap44x_product_id_registers,num_regs,0x4A002000);
-				break;
+	instance = &section->instances[choice - 1];
+	if(!avail_clocked(instance)) {
+		printf("%s is not clocked, its registers cannot be read\n", instance->name);
+		return;
+	}
 
-			case LCD_CONTROLLER:
-				// base 0x48041000
-				num_regs = ARRAY_SIZE(struct reg_info, omap44x_lcd_controller_registers);
-				printf("\n------------LCD Controller Registers-------------------:\n");
-				show_registers(omap44x_lcd_controller_registers,num_regs,0x48041000);
-				break;
+	printf("------------------ %s REGISTERS----------------\n", instance->name);
+	show_registers(section->regs, section->num_regs, instance->base, NULL);
+}
 
-			case DCAN:
-				printf("Need to write structure for DCAN\n");
-				break;
+static void usage(const char *prog) {
+	fprintf(stderr, "Usage:\t%s [-D desc] [-X] [-m memfile] [-s family] { reg }\n"
+		"\t%s [-B] [-X] [-m memfile] [-s family] [-i msec] [-n agents] [-H retention [-P file]] -d endpoint\n"
+		"\t%s [-B] [-X] [-m memfile] [-s family] [-i msec] -p shmname\n"
+		"\t%s -r shmname\n"
+		"\t%s [-B] [-X] [-m memfile] [-s family] [-i msec] -e { port | socket } [ pattern ]...\n"
+		"\t%s [-B] [-X] [-m memfile] [-s family] { -R | -G } golden\n"
+		"\t%s [-B] [-X] [-m memfile] [-s family] [-i msec] -T [ pattern ]...\n"
+		"\t%s [-B] [-X] [-m memfile] [-s family] -w [ op ]...\n"
+		"\t%s [-B] [-X] [-m memfile] [-s family] -S { script | - }\n"
+		"\t%s [-i msec] -F directory endpoint...\n"
+		"\t%s [-j threads] [-t percent] -A { snapfile | directory }...\n"
+		"\t%s [-D desc] [-m memfile] [-s family] -W desc\n"
+		"\t%s -c endpoint[,endpoint]... { read { reg }... | set name | snapshot | diff [seconds] | watch pattern... | bench [seconds] |\n"
+		"\t\t\trollup { 1s | 1m | 1h } reg [n] }\n"
+		"reg: desired register selection :[0]DCAN,[1]GPIO,[2]I2C,[3]LCD_CONTROLLER,[4]MCASP/MCBSP,[5]MCSPI,[6]MMCSD,[7]RTC,[8]TIMER,[9]TSC,[10]UART,[11]USB,[12]WDT,[13]PRODUT_ID,[14]LCD;\n"
+		"-m: file used instead of /dev/mem\n"
+		"-s: skip the detection, family is one of OMAP4, AM335x, OMAP35x\n"
+		"-D: use the register description file instead of the built-in tables of its family,\n"
+		"    with every other option; it is compiled once into desc.cache next to it\n"
+		"-W: write the register tables of the family as a description file\n"
+		"-B: probe which modules are clocked again, instead of using the list of this boot\n"
+		"-X: also read the FIFOs and the registers cleared by a read, taking the data of\n"
+		"    their driver; they are left out (read as 0) otherwise\n"
+		"-d: run as a daemon serving register reads, sampling every msec (100) for watchers\n"
+		"-c: send a command to a running daemon, read, snapshot and bench also to several at once\n"
+		"-n: simulated agents, the daemon also listens on the following ports (load tests)\n"
+		"-H: keep 1 s, 1 min and 1 h rollups of every register in the daemon, retention in\n"
+		"    windows per tier or in bytes with a K, M or G suffix; every tier keeps the same\n"
+		"    number N of windows, that is N seconds, N minutes and N hours\n"
+		"-P: save the rollups to a file every minute (the windows closed since), and restore\n"
+		"    them at startup\n"
+		"-F: collect snapshots of the agents every msec (100) into snapshot files\n"
+		"-R: record the registers in a golden reference, with the default masks of volatile bits\n"
+		"-G: compare the registers with a golden reference, exit status 2 if they deviate\n"
+		"-T: sample the registers matching the patterns (all by default) every msec (100) until\n"
+		"    interrupted, then print min/max/last and the toggles of every bit, also on SIGUSR1\n"
+		"-w: run a batch of writes in order, from the arguments or the standard input, one per line:\n"
+		"    write reg value, set reg bits, clear reg bits, field reg:FIELD value (or value name),\n"
+		"    verify reg value (write and read back), barrier (the writes before have completed)\n"
+		"-S: compile and run a register script: read, write, set, clear, field, poll reg mask value\n"
+		"    timeout, delay time, assert reg mask value; a field and its value may replace\n"
+		"    the mask and value; prints the value and the duration of every step\n"
+		"-A: report the registers on which a few units (-t, 10%%) differ from the majority,\n"
+		"    comparing the latest snapshot of every file with -j threads (all processors)\n"
+		"endpoint: Unix socket path, host:port, or a port on the loopback interface\n"
+		"-p: publish the snapshot of every register in shared memory every msec (100)\n"
+		"-r: print the snapshot published in shared memory\n"
+		"-e: serve the registers matching the patterns (all by default) and the sampler counters\n"
+		"    as Prometheus metrics, over HTTP on a loopback port or on a Unix socket\n",
+		prog, prog, prog, prog, prog, prog, prog, prog, prog, prog, prog, prog, prog);
+	exit(1);
+}
 
-			case GPIO:
-				printf("Need to write structure for GPIO\n");
+/*
+ * Main Routine for the program
+ */
+int main(int argc, char **argv) {
+	const struct soc_family *family;
+	const struct reg_section *section;
+	const char *daemon_path = NULL, *client_path = NULL, *family_name = NULL;
+	const char *shm_name = NULL, *reader_name = NULL, *export_endpoint = NULL;
+	const char *collect_dir = NULL, *golden_record = NULL, *golden_check = NULL;
+	const char *retention = NULL, *rollup_path = NULL;
+	const char *desc_path = NULL, *desc_out = NULL, *script_path = NULL;
+	struct reg_registry rr;
+	int n, opt, ret, interval_ms = 100, num_agents = 1;
+	int analysis = 0, toggle = 0, threads = 0, percent = 10, reprobe = 0, write = 0;
+
+	while((opt = getopt(argc, argv, "+m:s:d:c:p:r:i:e:n:F:Aj:t:R:G:TH:P:D:W:BXwS:")) != -1) {
+		switch(opt) {
+			case 'm':
+				mem_set_path(optarg);
 				break;
-
-			case I2C:
-				/* bases
-				* i2c3 0x48060000
-				* i2c1 0x48070000
-				* i2c2 0x48072000
-				* i2c4 0x48350000
-				*/
-				num_regs = ARRAY_SIZE(struct reg_info, omap44x_i2c_registers);
-				printf("\nI2C Registers:\n");
-				printf("Which one of the four I2Cs?? [1,2,3,4]:\n");
-				scanf("%d",&choice);
-
-				switch (choice) {
-					case 1:
-					printf("------------------ I2C1 REGISTERS----------------\n");
-					show_registers(omap44x_i2c_registers,num_regs,0x48070000);
-					break;
-
-					case 2:
-					printf("------------------ I2C2 REGISTERS----------------\n");
-					show_registers(omap44x_i2c_registers,num_regs,0x48072000);
-					break;
-
-					case 3:
-					printf("------------------ I2C3 REGISTERS----------------\n");
-					show_registers(omap44x_i2c_registers,num_regs,0x48060000);
-					break;
-
-					case 4:
-					printf("------------------ I2C4 REGISTERS----------------\n");
-					show_registers(omap44x_i2c_registers,num_regs,0x48350000);
-					break;
-
-					default:
-						printf("Wrong choice\n");
-				}
+			case 's':
+				family_name = optarg;
 				break;
-
-			case LCD:
-				// base 0x48040000
-				num_regs = ARRAY_SIZE(struct reg_info, omap44x_lcd_registers);
-				printf("\n------------ LCD Registers -----------------:\n");
-				show_registers(omap44x_lcd_registers,num_regs,0x48040000);
+			case 'd':
+				daemon_path = optarg;
 				break;
-
-			case MCASP:
-				// base 0x49028000
-				num_regs = ARRAY_SIZE(struct reg_info, omap44x_mcasp_registers);
-				printf("\n-------------- McASP Registers----------------:\n");
-				show_registers(omap44x_mcasp_registers,num_regs,0x49028000);
+			case 'c':
+				client_path = optarg;
 				break;
-
-			 case MCSPI:
-				/* bases
-				* MCSPI1	0x48098000
-				* MCSPI2	0x4809A000
-				* MCSPI3	0x480B8000
-				* MCSPI4	0x480BA000
-				*/
-				num_regs = ARRAY_SIZE(struct reg_info, omap44x_mcspi_registers);
-				printf("\nMcSPI Registers:\n");
-				printf("Which one of the four McSPIs?? [1,2,3,4]:\n");
-				scanf("%d",&choice);
-
-				switch (choice) {
-					case 1:
-					printf("------------------ MCSPI1 REGISTERS----------------\n");
-					show_registers(omap44x_mcspi_registers,num_regs,0x48098000);
-					break;
-
-					case 2:
-					printf("------------------ MCSPI2 REGISTERS----------------\n");
-					show_registers(omap44x_mcspi_registers,num_regs,0x4809A000);
-					break;
-
-					case 3:
-					printf("------------------ MCSPI3 REGISTERS----------------\n");
-					show_registers(omap44x_mcspi_registers,num_regs,0x480B8000);
-					break;
-
-					case 4:
-					printf("------------------ MCSPI4 REGISTERS----------------\n");
-					show_registers(omap44x_mcspi_registers,num_regs,0x480BA000);
-					break;
-
-					default:
-						printf("Wrong choice\n");
-				}
+			case 'p':
+				shm_name = optarg;
 				break;
-
-			case MMCSD:
-				/* bases
-				* MMCHS1	0x4809C000
-				* MMCHS2	0x480B4000
-				* MMCHS3	0x480AD000
-				* MMCHS4	0x480D1000
-				* MMCHS5	0x480D5000
-				*/
-				num_regs = ARRAY_SIZE(struct reg_info, omap44x_mmchs_registers);
-				printf("\nMMC/SD/SDIO Registers:\n");
-				printf("Which one of the 5 MMCHSs?? [1,2,3,4,5]:\n");
-				scanf("%d",&choice);
-
-				switch (choice) {
-					case 1:
-					printf("------------------ MMCHS1 REGISTERS----------------\n");
-					show_registers(omap44x_mmchs_registers,num_regs,0x4809C000);
-					break;
-
-					case 2:
-					printf("------------------ MMCHS2 REGISTERS----------------\n");
-					show_registers(omap44x_mmchs_registers,num_regs,0x480B4000);
-					break;
-
-					case 3:
-					printf("------------------ MMCHS3 REGISTERS----------------\n");
-					show_registers(omap44x_mmchs_registers,num_regs,0x480AD000);
-					break;
-
-					case 4:
-					printf("------------------ MMCHS4 REGISTERS----------------\n");
-					show_registers(omap44x_mmchs_registers,num_regs,0x480D1000);
-					break;
-
-					case 5:
-					printf("------------------ MMCHS5 REGISTERS----------------\n");
-					show_registers(omap44x_mmchs_registers,num_regs,0x480D5000);
-					break;
-
-					default:
-						printf("Wrong choice\n");
-				}
+			case 'r':
+				reader_name = optarg;
 				break;
-
-			case RTC:
- 				    break;
-
-			case TSC:
-				    break;
-
-			case UART:
-				/* bases
-				* uart1 0x4806A000
-				* uart2 0x4806C000
-				* uart3 0x48020000
-				* uart4 0x4806E000
-				*/
-				num_regs = ARRAY_SIZE(struct reg_info, omap44x_uart_registers);
-				printf("\nUART Registers:\n");
-				printf("Which one of the four UARTs?? [1,2,3,4]:\n");
-				scanf("%d",&choice);
-
-				switch (choice) {
-					case 1:
-					printf("------------------ UART1 REGISTERS----------------\n");
-					show_registers(omap44x_uart_registers,num_regs,0x4806A000);
-					break;
-
-					case 2:
-					printf("------------------ UART2 REGISTERS----------------\n");
-					show_registers(omap44x_uart_registers,num_regs,0x4806C000);
-					break;
-
-					case 3:
-					printf("------------------ UART3 REGISTERS----------------\n");
-					show_registers(omap44x_uart_registers,num_regs,0x48020000);
-					break;
-
-					case 4:
-					printf("------------------ UART4 REGISTERS----------------\n");
-					show_registers(omap44x_uart_registers,num_regs,0x4806E000);
-					break;
-
-					default:
-						printf("Wrong choice\n");
-				}
+			case 'e':
+				export_endpoint = optarg;
 				break;
-
-	 		case USB:
+			case 'n':
+				if((num_agents = atoi(optarg)) <= 0)
+					usage(argv[0]);
 				break;
-
-			case WDT:
-                                /*bases
-				WDT2   0x4A314000
-				WDT3   0x49030000
-				*/ 
-				num_regs = ARRAY_SIZE(struct reg_info, omap44x_wdt_registers);
-				printf("\nWDT Registers:\n");
-				printf("Which one of the two WDT's?? [1,2]:\n");
-				scanf("%d",&choice);
-
-				switch (choice) {
-					case 1:
-					printf("------------------ WDT2 REGISTERS----------------\n");
-					show_registers(omap44x_wdt_registers,num_regs,0x4A314000);
-					break;
-
-					case 2:
-					printf("------------------ WDT3 REGISTERS----------------\n");
-					show_registers(omap44x_wdt_registers,num_regs,0x49030000);
-					break;
-
-					default:
-						printf("Wrong choice\n");
-				}	                                
-					break;
-				
-			case TIMER:
-				/*General Purpose Timers(GPT) bases
-				GPTIMER1   0x4A318000
-				GPTIMER2   0x48032000
-				GPTIMER3   0x48034000
-				GPTIMER4   0x48036000
-				GPTIMER5   0x49038000
-				GPTIMER6   0x4903A000
-				GPTIMER7   0x4903C000
-				GPTIMER8   0x4903E000
-				GPTIMER9   0x4803E000
-				GPTIMER10  0x48086000
-				GPTIMER11  0x48088000
-				*/
-				num_regs = ARRAY_SIZE(struct reg_info, omap44x_gpt_registers);
-				printf("\nGeneral Purpose Timers Registers:\n");
-				printf("Which one of the eleven GPT's?? [1,2,3,4,5,6,7,8,9,10,11]:\n");
-				scanf("%d",&choice);
-
-				switch (choice) {
-					case 1:
-					printf("------------------ GPT1 REGISTERS----------------\n");
-					show_registers(omap44x_gpt_registers,num_regs,0x4A318000);
-					break;
-
-					case 2:
-					printf("------------------ GPT2 REGISTERS----------------\n");
-					show_registers(omap44x_gpt_registers,num_regs,0x48032000);
-					break;
-
-					case 3:
-					printf("------------------ GPT3 REGISTERS----------------\n");
-					show_registers(omap44x_gpt_registers,num_regs,0x48034000);
-					break;
-
-					case 4:
-					printf("------------------ GPT4 REGISTERS----------------\n");
-					show_registers(omap44x_gpt_registers,num_regs,0x48036000);
-					break;
-
-					case 5:
-					printf("------------------ GPT5 REGISTERS----------------\n");
-					show_registers(omap44x_gpt_registers,num_regs,0x49038000);
-					break;
-
-					case 6:
-					printf("------------------ GPT6 REGISTERS----------------\n");
-					show_registers(omap44x_gpt_registers,num_regs,0x4903A000);
-					break;
-					
-					case 7:
-					printf("------------------ GPT7 REGISTERS----------------\n");
-					show_registers(omap44x_gpt_registers,num_regs,0x4903C000);
-					break;
-
-					case 8:
-					printf("------------------ GPT8 REGISTERS----------------\n");
-					show_registers(omap44x_gpt_registers,num_regs,0x4903E000);
-					break;
-
-					case 9:
-					printf("------------------ GPT9 REGISTERS----------------\n");
-					show_registers(omap44x_gpt_registers,num_regs,0x48086000);
-					break;
-
-					case 10:
-					printf("------------------ GPT10 REGISTERS---------------\n");
-					show_registers(omap44x_gpt_registers,num_regs,0x48088000);
-					break;
-
-					case 11:
-					printf("------------------ GPT11 REGISTERS---------------\n");
-					show_registers(omap44x_gpt_registers,num_regs,0x49038000);
-					break;
-
-					default:
-						printf("Wrong choice\n");
-				}
+			case 'F':
+				collect_dir = optarg;
+				break;
+			case 'R':
+				golden_record = optarg;
+				break;
+			case 'G':
+				golden_check = optarg;
+				break;
+			case 'A':
+				analysis = 1;
+				break;
+			case 'T':
+				toggle = 1;
+				break;
+			case 'w':
+				write = 1;
+				break;
+			case 'S':
+				script_path = optarg;
+				break;
+			case 'H':
+				retention = optarg;
+				break;
+			case 'P':
+				rollup_path = optarg;
+				break;
+			case 'D':
+				desc_path = optarg;
+				break;
+			case 'W':
+				desc_out = optarg;
+				break;
+			case 'B':
+				reprobe = 1;
+				break;
+			case 'X':
+				plan_set_access(1);
+				break;
+			case 'j':
+				threads = atoi(optarg);
+				break;
+			case 't':
+				if((percent = atoi(optarg)) < 0 || percent > 100)
+					usage(argv[0]);
+				break;
+			case 'i':
+				if((interval_ms = atoi(optarg)) <= 0)
+					usage(argv[0]);
 				break;
-
 			default:
-				printf("Invalid section\n");
+				usage(argv[0]);
 		}
+	}
 
-		break;
-#endif		// _OMAP4_
-
-#ifdef _AM335x_
-		case AM335x:
-		switch (n) {
-			case DCAN  :
-			  	    printf("------------------- DCAN REGISTERS---------------- "); 
-				    num_regs = ARRAY_SIZE(struct reg_info, am335x_dcan_registers);
-				    /*base addresses 
-				    DCAN0 0x481CC000
-				    DCAN1 0X481D0000
-				    */	
-		                    printf("Which one of the DCAN's?? [1,2]:\n");
-				    scanf("%d",&choice);
-
-				    switch (choice) {
-					    case 1:
-					    printf("--------------------- DCAN0 REGISTERS------------------- \n");
-					    show_registers(am335x_dcan_registers,num_regs,0x481CC000);
-					    break;
-
-					    case 2:
-					    printf("-------------------- DCAN1 REGISTERS-------------------- \n"); 				
-				       	    show_registers(am335x_dcan_registers,num_regs,0x481D0000);
-					    break;
-
-					    default:
-					    printf("Wrong choice\n");
-				    }
-	 		            break;
-			 
-			 case GPIO  :
-				    /* base addresses
-				    GPIO0   0x44E07000
-				    GPIO1   0x4804C000
-				    GPIO2   0x481AC000
-				    GPIO3   0x481AE000
-				    */
-				    printf("------------------- GPIO REGISTERS---------------- \n");
-			            num_regs = ARRAY_SIZE(struct reg_info, am335x_gpio_registers);
-	    		            printf("Which one of the GPIO's?? [1,2,3,4]:\n");
-				    scanf("%d",&choice);
-
-				    switch (choice) {
-				            case 1:
-					    printf("--------------------- GPIO0 REGISTERS-------------------\n "); 
-					    show_registers(am335x_gpio_registers,num_regs,0x44E07000);
-					    break;
-
-				            case 2:
-					    printf("--------------------- GPIO1 REGISTERS------------------- \n"); 				
-					    show_registers(am335x_gpio_registers,num_regs,0x4804C000);
-					    break;
-					
-					    case 3:
-					    printf("--------------------- GPIO2 REGISTERS------------------- \n"); 				
-					    show_registers(am335x_gpio_registers,num_regs,0x480AC000);
-					    break;
-
-					    case 4:
-					    printf("--------------------- GPIO3 REGISTERS------------------- \n"); 				
-					    show_registers(am335x_gpio_registers,num_regs,0x480AE000);
-					    break;
-
-					    default:
-					    printf("Wrong choice\n");
-				    }
-				    break;
-
-			 case I2C   :
-				    /*base addresses
-				    I2C0   0x44E0B000
-				    I2C1   0x4802A000
-				    I2C2   0x4819C000
-				    */				
-				    printf("------------------ I2C REGISTERS----------------- ");
-				    num_regs = ARRAY_SIZE(struct reg_info, am335x_i2c_registers);
-				    printf("Which one of the I2C's?? [1,2,3]:\n");
-				    scanf("%d",&choice);
-
-				    switch (choice) {
-					    case 1:
-					    printf("-------------------- I2C0 REGISTERS-------------------- \n"); 
-					    show_registers(am335x_i2c_registers,num_regs,0x44E0B000);
-					    break;
-
-				            case 2:
-					    printf("-------------------- I2C1 REGISTERS-------------------- \n"); 				
-					    show_registers(am335x_i2c_registers,num_regs,0x4802A000);
-					    break;
-					
-					    case 3:
-					    printf("-------------------- I2C2 REGISTERS-------------------- \n"); 				
-					    show_registers(am335x_i2c_registers,num_regs,0x4819C000);
-					    break;
-
-					    default:
-					    printf("Wrong choice\n");
-				    }
-				    break;
-			
-			 case LCD_CONTROLLER:
-				    // base address LCD_CONTROLLER  0x4830E000
-				    printf("------------------- LCD CONTROLLER REGISTERS---------------------- \n");
-				    num_regs = ARRAY_SIZE(struct reg_info, am335x_lcd_controller_registers);		
-				    show_registers(am335x_lcd_controller_registers,num_regs,0x4830E000);
-				    break;
-
-			 case MCASP:
-				    /* base addresses
-				    MCASP0   0x48038000
-				    MCASP1   0X4803C000
-				    */
-				    printf("------------------- MCASP REGISTERS---------------- \n");
-				    num_regs = ARRAY_SIZE(struct reg_info, am335x_mcasp_registers);
-				    printf("Which one of the MCASP's?? [1,2]:\n");
-				    scanf("%d",&choice);
-
-				    switch (choice) {
-					    case 1:
-					    printf("----------------------- MCASP0 REGISTERS----------------- \n"); 
-					    show_registers(am335x_mcasp_registers,num_regs,0x48038000);
-					    break;
-
-					    case 2:
-					    printf("----------------------- MCASP1 REGISTERS----------------- \n"); 						    show_registers(am335x_mcasp_registers,num_regs,0x4803C000);
-					    break;
-
-					    default:
-					    printf("Wrong choice\n");
-				    }
-				    break;
-
-			 case MCSPI :
-				    /*base addresses
-				    MCSPI0   0x48030000
-				    MCSPI1   0x481A0000
-				    */
-				    printf("-------------- MCSPI REGISTERS------------- \n");
-				    num_regs = ARRAY_SIZE(struct reg_info, am335x_mcspi_registers);	
-				    printf("Which one of the MCSPI's?? [1,2]:\n");
-				    scanf("%d",&choice);
-
-				    switch (choice) {
-					    case 1:
-					    printf("--------------------- MCSPI0 REGISTERS------------------- \n"); 
-					    show_registers(am335x_mcspi_registers,num_regs,0x48030000);
-					    break;
-
-				            case 2:
-					    printf("--------------------- MCSPI1 REGISTERS------------------- \n"); 				
-					    show_registers(am335x_mcspi_registers,num_regs,0x481A0000);
-					    break;
-
-				   	    default:
-					    printf("Wrong choice\n");
-					}
-				    break;
-
-			 case MMCSD :
-				    /*
-				    base addresses 
-				    MMCHS0   0x48060000
-				    MMC1     0x481D8000
-				    MMCHS2   0x47810000
-				    */
-				    printf("-------------- MMC/SD REGISTERS------------- \n");
-				    num_regs = ARRAY_SIZE(struct reg_info, am335x_mmchs_registers);
-		                    printf("Which one of the MMCHS's?? [1,2,3]:\n");
-				    scanf("%d",&choice);
-
-				    switch (choice) {
-				            case 1:
-					    printf("--------------------- MMCHS0 REGISTERS------------------- \n"); 
-					    show_registers(am335x_mmchs_registers,num_regs,0x48060000);
-					    break;
-
-					    case 2:
-					    printf("--------------------- MMC1 REGISTERS--------------------- \n"); 				
-					    show_registers(am335x_mmchs_registers,num_regs,0x481D8000);
-					    break;
-					
-					    case 3:
-					    printf("--------------------- MMCHS2 REGISTERS------------------- \n"); 				
-					    show_registers(am335x_mmchs_registers,num_regs,0x47810000);
-					    break;
-
-					    default:
-					    printf("Wrong choice\n");
-				    }
-				    break;
-
-			 case RTC   :
-				    // base address RTCSS   0x44E3E000
-				    printf("-------------------- RTC REGISTERS--------------------- \n");
-				    num_regs = ARRAY_SIZE(struct reg_info, am335x_rtc_registers);
-		                    show_registers(am335x_rtc_registers,num_regs,0x44E3E000);
-				    break;
-
-			 case TIMER :
-				    /*
-				    base addresses
-				    DMTIMER0   0x44E05000
-				    DMTIMER1   0x44E31000 
-				    DMTIMER2   0x48040000
-				    DMTIMER3   0x48042000
-				    DMTIMER4   0x48044000
-				    DMTIMER5   0x48046000
-				    DMTIMER6   0x48048000
-				    DMTIMER7   0x4804A000
-				    */
-				    printf("---------------- TIMER REGISTERS------------------- ");
-				    num_regs = ARRAY_SIZE(struct reg_info, am335x_timer_registers);
-		                    printf("Which one of the TIMER's?? [1,2,3,4,5,6,7,8]:\n");
-				    scanf("%d",&choice);
-
-				    switch (choice) {
-				            case 1:
-					    printf("-------------------- TIMER0 REGISTERS-------------------- "); 
-					    show_registers(am335x_timer_registers,num_regs,0x44E05000);
-					    break;
-
-					    case 2:
-					    printf("-------------------- TIMER1 REGISTERS-------------------- "); 				
-					    show_registers(am335x_timer_registers,num_regs,0x48E31000);
-					    break;
-				
-			    		    case 3:
-					    printf("-------------------- TIMER2 REGISTERS-------------------- ");			
-					    show_registers(am335x_timer_registers,num_regs,0x48040000);
-					    break;
-
-					    case 4:
-					    printf("-------------------- TIMER3 REGISTERS-------------------- ");			
-					    show_registers(am335x_timer_registers,num_regs,0x48042000);
-					    break;
-
-					    case 5:
-					    printf("-------------------- TIMER4 REGISTERS-------------------- ");			
-					    show_registers(am335x_timer_registers,num_regs,0x48044000);
-					    break;
-
-					    case 6:
-					    printf("-------------------- TIMER5 REGISTERS-------------------- ");			
-					    show_registers(am335x_timer_registers,num_regs,0x48046000);
-					    break;
-
-					    case 7:
-					    printf("-------------------- TIMER6 REGISTERS-------------------- "); 				
-				  	    show_registers(am335x_timer_registers,num_regs,0x48048000);
-					    break;
-
-					    case 8:
-					    printf("-------------------- TIMER7 REGISTERS-------------------- "); 				
-					    show_registers(am335x_timer_registers,num_regs,0x4804A000);
-					    break;
-
-					    default:
-					    printf("Wrong choice\n");
-				    }
-				    break;
-		 
-			 case TSC   :
-				    // base address ADC_TSC   0x44E0D000
-				    printf("-------------------- TSC REGISTERS--------------------- ");
-				    num_regs = ARRAY_SIZE(struct reg_info, am335x_tsc_registers);
-		                    show_registers(am335x_tsc_registers,num_regs,0x44E0D000);
-				    break;
-
-		         case UART  :
-				    /*
-				    base addresses
-				    UART0   0x44E09000
-				    UART1   0x48022000
-				    UART2   0x48024000
-				    UART3   0x481A6000
-				    UART4   0x481A8000
-				    UART5   0x481AA000
-				    */
-				    printf("-------------------- UART REGISTERS--------------- ");
-				    num_regs = ARRAY_SIZE(struct reg_info, am335x_uart_registers);
-		 	            printf("Which one of the UART's?? [1,2,3,4,5,6]:\n");
-				    scanf("%d",&choice);
-
-				    switch (choice) {
-					    case 1:
-					    printf("----------------------- UART0 REGISTERS----------------- "); 
-					    show_registers(am335x_uart_registers,num_regs,0x44E09000);
-					    break;
-
-					    case 2:
-					    printf("----------------------- UART1 REGISTERS----------------- ");  				
-					    show_registers(am335x_uart_registers,num_regs,0x48022000);
-					    break;
-					
-					    case 3:
-					    printf("----------------------- UART2 REGISTERS----------------- ");  				
-					    show_registers(am335x_uart_registers,num_regs,0x48024000);
-					    break;
+	if(desc_path != NULL && desc_load(desc_path) == -1)
+		exit(1);
 
-					    case 4:
-					    printf("----------------------- UART3 REGISTERS----------------- "); 				
-					    show_registers(am335x_uart_registers,num_regs,0x481A6000);
-					    break;
+	if(client_path != NULL)
+		return run_client(client_path, argc - optind, argv + optind);
 
-					    case 5:
-					    printf("----------------------- UART4 REGISTERS----------------- "); 				
-					    show_registers(am335x_uart_registers,num_regs,0x481A8000);
-					    break;
+	if(reader_name != NULL)
+		return run_shm_reader(reader_name);
 
-					    case 6:
-					    printf("----------------------- UART5 REGISTERS----------------- "); 				
-					    show_registers(am335x_uart_registers,num_regs,0x481AA000);
-					    break;
+	if(analysis)
+		return run_analysis(threads, percent, argc - optind, argv + optind);
 
-					    default:
-					    printf("Wrong choice\n");
-				    }
-				    break;
+	if(collect_dir != NULL)
+		return run_collector(collect_dir, interval_ms, argc - optind, argv + optind);
 
-			 case USB   :
-				    // base address USBSS   0x47400000
-				    printf("---------------------- USBSS REGISTERS----------------- ");
-				    num_regs = ARRAY_SIZE(struct reg_info, am335x_usb_registers);
-				    show_registers(am335x_usb_registers,num_regs,0x47400000);
-				    break;
+	if(daemon_path == NULL && shm_name == NULL && export_endpoint == NULL &&
+	   golden_record == NULL && golden_check == NULL && !toggle && !write && script_path == NULL &&
+	   desc_out == NULL &&
+	   optind >= argc)
+		usage(argv[0]);
 
-			 case WDT   :
-				    // base addresses WDT1   0x44E35000 
-				    printf("---------------- WDT1 REGISTERS------------------------ ");
-				    num_regs = ARRAY_SIZE(struct reg_info, am335x_wdt_registers);
-		                    show_registers(am335x_wdt_registers,num_regs,0x44E35000);
-				    break;
-		
-			 case PRODUCT_ID:
-				    // base 0x4A002000
-				    num_regs = ARRAY_SIZE(struct reg_info, am335x_product_id_registers);
-				    printf("\n-----------------Product ID Registers:---------------------\n");
-				    show_registers(am335x_product_id_registers,num_regs,0x44E10600);
-				    break;
-			 case LCD   :
-  				    break;
-		     
-		  	 default   :
-			 	    printf("Invalid Selection" );
+	if(family_name != NULL) {
+		if((family = find_family(family_name)) == NULL) {
+			fprintf(stderr, "Unknown processor family %s\n", family_name);
+			exit(1);
 		}
+		identify_soc(family);
+	}
+	else
+		family = read_processor();	// which processor we are working on
 
-		break;
-#endif	// _AM335x_
-
-#ifdef _OMAP35x_
-		case OMAP35x:
-		switch(n) {
-			case PRODUCT_ID:
-					// base 0x4830A204
-					num_regs = ARRAY_SIZE(struct reg_info, omap35x_product_id_registers);
-					printf("\n-------------------Product ID Registers:--------------------\n");
-					show_registers(omap35x_product_id_registers,num_regs,0x4830A204);
-					break;
-
-			case LCD_CONTROLLER:
-					// base 0x48050400
-					num_regs = ARRAY_SIZE(struct reg_info, omap35x_lcd_controller_registers);
-					printf("\n----------------LCD Controller Registers:-----------------------\n");
-					show_registers(omap35x_lcd_controller_registers,num_regs,0x48050400);
-					break;
-
-			case DCAN:
-					printf("DCAN not available on the Processor\n");
-					break;
-
-			case GPIO:
-					printf("GPIO not available on the Processor\n");
-					break;
-
-			case I2C:
-					/* base addresses
-					I2C1   0x48070000  
-					I2C2   0x48072000 
-					I2C3   0x48060000
-					*/
-					num_regs = ARRAY_SIZE(struct reg_info, omap35x_i2c_registers);
-					printf("\nI2C Registers:\n");
-					printf("Which one of the three I2Cs?? [1,2,3]:\n");
-					scanf("%d",&choice);
-
-					switch (choice) {
-						case 1:
-						printf("-------------------- I2C0 REGISTERS----------------------"); 
-						show_registers(omap35x_i2c_registers,num_regs,0x48070000);
-						break;
-
-						case 2:
-						printf("------------------- I2C1 REGISTERS-----------------------"); 
-						show_registers(omap35x_i2c_registers,num_regs,0x48072000);
-						break;
-
-						case 3:
-						printf("-------------------- I2C2 REGISTERS----------------------"); 
-						show_registers(omap35x_i2c_registers,num_regs,0x48060000);
-						break;
-
-						default:
-							printf("Wrong choice\n");
-					}
-					break;
-
-			case LCD:
-					// base 0x48050000
-					num_regs = ARRAY_SIZE(struct reg_info, omap35x_lcd_registers);
-					printf("\nLCD Registers:\n");
-					show_registers(omap35x_lcd_registers,num_regs,0x48050000);
-					break;
-
-			case MCBSP:
-					/* base addresses
-					McBSP1         	  0x48074000 
-					McBSP2 		  0x49022000 
-					McBSP3 		  0x49024000 
-					McBSP4 		  0x49026000 
-					McBSP5 		  0x48096000 
-					SIDETONE_McBSP2   0x49028000 
-					SIDETONE_McBSP3   0x4902A000
-					*/
-					num_regs = ARRAY_SIZE(struct reg_info, omap35x_mcbsp_registers);
-					printf("\nMcBSP Registers:\n");
-					printf("Which one of the seven McBSP's?? [1,2,3,4,5,6,7]:\n");
-					scanf("%d",&choice);
-
-					switch (choice) {
-						case 1:
-						printf("-------------------- MCBSP1 REGISTERS----------------------"); 
-						show_registers(omap35x_mcbsp_registers,num_regs,0x48074000);
-						break;
-
-						case 2:
-						printf("------------------- MCBSP2 REGISTERS-----------------------"); 
-						show_registers(omap35x_mcbsp_registers,num_regs,0x49022000);
-						break;
-
-						case 3:
-						printf("-------------------- MCBSP3 REGISTERS----------------------"); 
-						show_registers(omap35x_mcbsp_registers,num_regs,0x49024000);
-						break;
-
-						case 4:
-						printf("-------------------- MCBSP4 REGISTERS----------------------"); 
-						show_registers(omap35x_mcbsp_registers,num_regs,0x49026000);
-						break;
-
-						case 5:
-						printf("------------------- MCBSP5 REGISTERS-----------------------"); 
-						show_registers(omap35x_mcbsp_registers,num_regs,0x48096000);
-						break;
-
-						case 6:
-						printf("----------------- SIDETONE_MCBSP2 REGISTERS----------------"); 
-						show_registers(omap35x_mcbsp_registers,num_regs,0x49028000);
-						break;
-
-						case 7:
-						printf("----------------- SIDETONE_MCBSP3 REGISTERS----------------"); 
-						show_registers(omap35x_mcbsp_registers,num_regs,0x4902A000);
-						break;
-
-						default:
-							printf("Wrong choice\n");
-					}
-					break;
-
-			 case MCSPI:
-					/* base addresses 
-					MCSPI1   0x48098000 
-					MCSPI2   0x4809A000 
-					MCSPI3   0x480B8000 
-					MCSPI4   0x480BA000
-					*/
-					num_regs = ARRAY_SIZE(struct reg_info, omap35x_mcspi_registers);
-					printf("\nMcSPI Registers:\n");
-					printf("Which one of the four McSPIs?? [1,2,3,4]:\n");
-					scanf("%d",&choice);
-
-					switch (choice) {
-						case 1:
-						printf("--------------------- MCSPI1 REGISTERS---------------------"); 
-						show_registers(omap35x_mcspi_registers,num_regs,0x48098000);
-						break;
-
-						case 2:
-						printf("--------------------- MCSPI2 REGISTERS---------------------"); 
-						show_registers(omap35x_mcspi_registers,num_regs,0x4809A000);
-						break;
-
-						case 3:
-						printf("--------------------- MCSPI3 REGISTERS---------------------"); 
-						show_registers(omap35x_mcspi_registers,num_regs,0x480B8000);
-						break;
-
-						case 4:
-						printf("--------------------- MCSPI4 REGISTERS---------------------"); 
-						show_registers(omap35x_mcspi_registers,num_regs,0x480BA000);
-						break;
-
-						default:
-							printf("Wrong choice\n");
-					}
-					break;
-
-			 case MMCSD:
-					/* base addresses 
-					MMCHS1   0x4809C000 
-					MMCHS2   0x480B4000  
-					MMCHS3   0x480AD000
-					*/
-					num_regs = ARRAY_SIZE(struct reg_info, omap35x_mmchs_registers);
-					printf("\nMMC/SD/SDIO Registers:\n");
-					printf("Which one of the 3 MMCHSs?? [1,2,3]:\n");
-					scanf("%d",&choice);
-
-					switch (choice) {
-						case 1:
-						printf("--------------------- MMCHS1 REGISTERS---------------------");
-						show_registers(omap35x_mmchs_registers,num_regs,0x4809C000);
-						break;
-
-						case 2:
-						printf("--------------------- MMCHS2 REGISTERS---------------------");
-						show_registers(omap35x_mmchs_registers,num_regs,0x480B4000);
-						break;
-
-						case 3:
-						printf("--------------------- MMCHS3 REGISTERS---------------------");
-						show_registers(omap35x_mmchs_registers,num_regs,0x480AD000);
-						break;
-
-						default:
-							printf("Wrong choice\n");
-					}
-					break;
-			 case RTC:
- 				        break;
-			 case TSC:
-				    	break;
-
-			 case UART:
-					/* base addresses
-					UART1   0x4806A000
-					UART2   0x4806C000
-					UART3   0x49020000
-					*/
-					num_regs = ARRAY_SIZE(struct reg_info, omap35x_uart_registers);
-					printf("\nUART Registers:\n");
-					printf("Which one of the three UARTs?? [1,2,3]:\n");
-					scanf("%d",&choice);
-
-					switch (choice) {
-						case 1:
-						printf("--------------------- UART1 REGISTERS---------------------");
-						show_registers(omap35x_uart_registers,num_regs,0x4806A000);
-						break;
-
-						case 2:
-						printf("--------------------- UART2 REGISTERS---------------------");
-						show_registers(omap35x_uart_registers,num_regs,0x4806C000);
-						break;
-
-						case 3:
-						printf("--------------------- UART3 REGISTERS---------------------");
-						show_registers(omap35x_uart_registers,num_regs,0x49020000);
-						break;
-
-						default:
-							printf("Wrong choice\n");
-					}
-					break;
-
-	 		case USB:
-					// base address USBTLL   0x48062000
-					num_regs = ARRAY_SIZE(struct reg_info, omap35x_usbttlhs_config_registers);
-					printf("\n----------------------USBTLL Registers:--------------------------\n");
-					show_registers(omap35x_usbttlhs_config_registers,num_regs,0x48062000);
-					break;				
-
-			case WDT:
-					/* base addresses
-					WDTIMER2   0x48314000 
-					WDTIMER3   0x49030000
-					*/
-					num_regs = ARRAY_SIZE(struct reg_info, omap35x_wdt_registers);
-					printf("\nWDT Registers:\n");
-					printf("Which one of the two WDT's?? [1,2]:\n");
-					scanf("%d",&choice);
-
-					switch (choice) {
-						case 1:
-						printf("--------------------- WDT2 REGISTERS---------------------");
-						show_registers(omap35x_wdt_registers,num_regs,0x48314000);
-						break;
-
-						case 2:
-						printf("--------------------- WDT3 REGISTERS---------------------");
-						show_registers(omap35x_wdt_registers,num_regs,0x49030000);
-						break;
-
-						default:
-							printf("Wrong choice\n");
-					}	                                
-						break;
-				
-			case TIMER:
-					/* base addresses
-					GPTIMER1   0x48318000 
-					GPTIMER2   0x49032000 
-					GPTIMER3   0x49034000 
-					GPTIMER4   0x49036000 
-					GPTIMER5   0x49038000 
-					GPTIMER6   0x4903A000 
-					GPTIMER7   0x4903C000 
-					GPTIMER8   0x4903E000 
-					GPTIMER9   0x49040000
-					GPTIMER10  0x48086000 
-					GPTIMER11  0x48088000
-					*/
-					num_regs = ARRAY_SIZE(struct reg_info, omap35x_gpt_registers);
-					printf("\nGeneral Purpose Timers Registers:\n");
-					printf("Which one of the eleven GPT's?? [1,2,3,4,5,6,7,8,9,10,11]:\n");
-					scanf("%d",&choice);
-
-					switch (choice) {
-						case 1:
-						printf("--------------------- GPT1 REGISTERS---------------------");
-						show_registers(omap35x_gpt_registers,num_regs,0x48318000);
-						break;
-
-						case 2:
-						printf("--------------------- GPT2 REGISTERS---------------------");
-						show_registers(omap35x_gpt_registers,num_regs,0x49032000);
-						break;
-
-						case 3:
-						printf("--------------------- GPT3 REGISTERS---------------------");
-						show_registers(omap35x_gpt_registers,num_regs,0x49034000);
-						break;
-
-						case 4:
-						printf("--------------------- GPT4 REGISTERS---------------------");
-						show_registers(omap35x_gpt_registers,num_regs,0x49036000);
-						break;
-
-						case 5:
-						printf("--------------------- GPT5 REGISTERS---------------------");
-						show_registers(omap35x_gpt_registers,num_regs,0x49038000);
-						break;
-
-						case 6:
-						printf("--------------------- GPT6 REGISTERS---------------------");
-						show_registers(omap35x_gpt_registers,num_regs,0x4903A000);
-						break;
-					
-						case 7:
-						printf("--------------------- GPT7 REGISTERS---------------------");
-						show_registers(omap35x_gpt_registers,num_regs,0x4903C000);
-						break;
-
-						case 8:
-						printf("--------------------- GPT8 REGISTERS---------------------");
-						show_registers(omap35x_gpt_registers,num_regs,0x4903E000);
-						break;
-
-						case 9:
-						printf("--------------------- GPT9 REGISTERS---------------------");
-						show_registers(omap35x_gpt_registers,num_regs,0x49040000);
-						break;
-
-						case 10:
-						printf("--------------------- GPT10 REGISTERS--------------------");
-						show_registers(omap35x_gpt_registers,num_regs,0x48086000);
-						break;
-
-						case 11:
-						printf("--------------------- GPT11 REGISTERS--------------------");
-						show_registers(omap35x_gpt_registers,num_regs,0x48088000);
-						break;
-
-						default:
-							printf("Wrong choice\n");
-					}
-					break;
+	if(family == NULL) {
+		printf("Processor not supported by the current program\n");
+		return 0;
+	}
 
-			default:
-				printf("Invalid section\n");
-		}
+	if(desc_out != NULL)
+		return desc_export(family, desc_out);
+
+	if(daemon_path != NULL || shm_name != NULL || export_endpoint != NULL ||
+	   golden_record != NULL || golden_check != NULL || toggle || write || script_path != NULL) {
+		if(registry_build(&rr, family) == -1) FATAL;
+		avail_init(&rr, reprobe);
+		if(golden_record != NULL)
+			ret = run_golden_record(golden_record, &rr);
+		else if(golden_check != NULL)
+			ret = run_golden_check(golden_check, &rr);
+		else if(toggle)
+			ret = run_toggle_capture(&rr, interval_ms, argc - optind, argv + optind);
+		else if(write)
+			ret = run_write(&rr, argc - optind, argv + optind);
+		else if(script_path != NULL)
+			ret = run_script(&rr, script_path);
+		else if(daemon_path != NULL)
+			ret = run_daemon(daemon_path, &rr, interval_ms, num_agents,
+					 retention, rollup_path);
+		else if(export_endpoint != NULL)
+			ret = run_exporter(export_endpoint, &rr, interval_ms,
+					   argc - optind, argv + optind);
+		else
+			ret = run_publisher(shm_name, &rr, interval_ms);
+		registry_free(&rr);
+		return ret;
+	}
 
-		break;
-#endif 		// _OMAP35x_
+	n = atoi(argv[optind]);
+	if(n < 0 || n >= NUM_SECTIONS) {
+		printf("Invalid section\n");
+		return 0;
+	}
 
-		default:
-		printf("Processor not supported by the current program\n");
+	section = find_section(family, n);
+	if(section == NULL) {
+		printf("%s not available on the Processor\n", section_names[n]);
+		return 0;
 	}
 
+	show_section(section);
+
 	return 0;
 }
@@ -0,0 +1,401 @@
+/*
+ * exporter.c : register values and sampler health in the Prometheus text format
+ *
+ * The exporter samples a configured set of registers at a fixed interval and
+ * renders the whole page right after each sample, along with its own
+ * counters. A scrape only copies the last rendered page, it never touches the
+ * hardware, so any number of collectors can poll it at any rate.
+ *
+ * Every label set is fixed by the configuration: a register and its fields
+ * are series whose values change, never labels, so the number of series a
+ * collector stores does not grow with what the registers do.
+ *
+ * The page is served either over HTTP on a TCP endpoint, the loopback
+ * interface unless an address is given (see net.c), or on a Unix socket where
+ * a connection receives the bare page and is closed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include "devicedbg.h"
+
+#define EX_MAX_CLIENTS	16
+#define EX_REQUEST_MAX	4096
+
+struct ex_conn {
+	int fd;
+	char req[EX_REQUEST_MAX];	/* HTTP request head */
+	size_t req_len;
+	char *out;			/* response, NULL while reading the request */
+	size_t out_off, out_len;
+};
+
+struct ex_stats {
+	uint64_t samples;
+	uint64_t overruns;		/* samples taken later than one interval */
+	uint64_t read_ns, last_read_ns;	/* time spent running the read plan */
+	uint64_t scrapes;
+	uint64_t rejected;		/* connections refused, too many clients */
+};
+
+static struct ex_conn conns[EX_MAX_CLIENTS];
+static int num_conns;
+static int http;			/* HTTP on TCP, bare page on Unix socket */
+
+static char *page;			/* last rendered page */
+static size_t page_len, page_size;
+
+static volatile sig_atomic_t exporter_quit;
+
+static void exporter_signal(int sig) {
+	exporter_quit = 1;
+}
+
+static void page_printf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+static void page_printf(const char *fmt, ...) {
+	va_list ap;
+	int n;
+
+	for(;;) {
+		va_start(ap, fmt);
+		n = vsnprintf(page + page_len, page_size - page_len, fmt, ap);
+		va_end(ap);
+
+		if(n < page_size - page_len)
+			break;
+
+		page_size = page_size ? 2 * page_size : 65536;
+		if((page = realloc(page, page_size)) == NULL) FATAL;
+	}
+
+	page_len += n;
+}
+
+/*
+ * Escapes a label value as the text format wants it: backslash, double
+ * quote and line feed. Register and field names can come from a loaded
+ * description (-D), so they may hold any of these.
+ * Input:
+ *	const char *s, size_t len	- value
+ *	char *buf			- receives 2 * len + 1 bytes at most
+ *
+ * Output:
+ *	buf
+ */
+static const char *label_escape(const char *s, size_t len, char *buf) {
+	char *p = buf;
+
+	for(; len > 0 && *s != '\0'; s++, len--) {
+		if(*s == '\\' || *s == '"')
+			*p++ = '\\';
+		else if(*s == '\n') {
+			*p++ = '\\';
+			*p++ = 'n';
+			continue;
+		}
+		*p++ = *s;
+	}
+	*p = '\0';
+
+	return buf;
+}
+
+/* Renders the page from the last sample */
+static void exporter_render(const struct reg_registry *rr, const int *indices, int n,
+			    const uint32_t *values, const struct ex_stats *st) {
+	char qname[REG_NAME_LEN], name[2 * REG_NAME_LEN], field[2 * REG_NAME_LEN];
+	int i;
+
+	page_len = 0;
+
+	page_printf("# HELP devicedbg_info Register tables in use.\n"
+		    "# TYPE devicedbg_info gauge\n"
+		    "devicedbg_info{family=\"%s\",hash=\"%08X\"} 1\n",
+		    label_escape(rr->family->name, REG_NAME_LEN - 1, name), rr->hash);
+
+	page_printf("# HELP devicedbg_register Register value at the last sample.\n"
+		    "# TYPE devicedbg_register gauge\n");
+	for(i = 0; i < n; i++) {
+		const struct reg_entry *e = &rr->entries[indices[i]];
+
+		reg_entry_name(e, qname);
+		page_printf("devicedbg_register{name=\"%s\",address=\"0x%08lX\"} %u\n",
+			    label_escape(qname, sizeof(qname), name), e->addr, values[i]);
+	}
+
+	// one series per field, its value as the sample: labels which do not
+	// change with the value, so a flapping status bit is not a new series
+	page_printf("# HELP devicedbg_register_field Value of a field of a register, at the last sample.\n"
+		    "# TYPE devicedbg_register_field gauge\n");
+	for(i = 0; i < n; i++) {
+		const struct reg_entry *e = &rr->entries[indices[i]];
+		const struct reg_field *f;
+
+		if(e->reg->fields == NULL)
+			continue;
+
+		label_escape(reg_entry_name(e, qname), sizeof(qname), name);
+		for(f = e->reg->fields; f->name != NULL; f++)
+			page_printf("devicedbg_register_field{name=\"%s\",field=\"%s\"} %u\n", name,
+				    label_escape(f->name, REG_NAME_LEN - 1, field),
+				    (values[i] & reg_field_mask(f)) >> f->shift);
+	}
+
+	page_printf("# HELP devicedbg_samples_total Samples taken.\n"
+		    "# TYPE devicedbg_samples_total counter\n"
+		    "devicedbg_samples_total %llu\n"
+		    "# HELP devicedbg_sample_overruns_total Samples taken more than one interval late.\n"
+		    "# TYPE devicedbg_sample_overruns_total counter\n"
+		    "devicedbg_sample_overruns_total %llu\n",
+		    (unsigned long long) st->samples, (unsigned long long) st->overruns);
+
+	page_printf("# HELP devicedbg_read_seconds Time spent reading the registers of a sample.\n"
+		    "# TYPE devicedbg_read_seconds summary\n"
+		    "devicedbg_read_seconds_sum %.9f\n"
+		    "devicedbg_read_seconds_count %llu\n"
+		    "# HELP devicedbg_last_read_seconds Read time of the last sample.\n"
+		    "# TYPE devicedbg_last_read_seconds gauge\n"
+		    "devicedbg_last_read_seconds %.9f\n",
+		    st->read_ns / 1e9, (unsigned long long) st->samples, st->last_read_ns / 1e9);
+
+	page_printf("# HELP devicedbg_mapped_pages Register pages mapped.\n"
+		    "# TYPE devicedbg_mapped_pages gauge\n"
+		    "devicedbg_mapped_pages %d\n"
+		    "# HELP devicedbg_scrapes_total Pages served to scrapers, up to the last sample.\n"
+		    "# TYPE devicedbg_scrapes_total counter\n"
+		    "devicedbg_scrapes_total %llu\n"
+		    "# HELP devicedbg_rejected_total Connections dropped, too many clients.\n"
+		    "# TYPE devicedbg_rejected_total counter\n"
+		    "devicedbg_rejected_total %llu\n",
+		    mem_num_maps(), (unsigned long long) st->scrapes,
+		    (unsigned long long) st->rejected);
+}
+
+/* Queues the response to a complete request */
+static int conn_respond(struct ex_conn *c, struct ex_stats *st) {
+	static const char *not_found = "HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\n"
+				       "Connection: close\r\n\r\n";
+	char head[160];
+	int n = 0;
+
+	if(http) {
+		if(strncmp(c->req, "GET /metrics ", 13) != 0 && strncmp(c->req, "GET / ", 6) != 0) {
+			n = strlen(not_found);
+			if((c->out = strdup(not_found)) == NULL)
+				return -1;
+			c->out_len = n;
+			return 0;
+		}
+
+		n = snprintf(head, sizeof(head), "HTTP/1.0 200 OK\r\n"
+			     "Content-Type: text/plain; version=0.0.4\r\n"
+			     "Content-Length: %zu\r\nConnection: close\r\n\r\n", page_len);
+	}
+
+	if((c->out = malloc(n + page_len + 1)) == NULL)
+		return -1;
+
+	memcpy(c->out, head, n);
+	memcpy(c->out + n, page, page_len);
+	c->out_len = n + page_len;
+	st->scrapes++;
+
+	return 0;
+}
+
+/* Reads the request head of an HTTP connection
+ * Output:
+ *	0 on success, -1 if the connection has to be dropped
+ */
+static int conn_input(struct ex_conn *c, struct ex_stats *st) {
+	ssize_t n;
+
+	n = read(c->fd, c->req + c->req_len, sizeof(c->req) - 1 - c->req_len);
+	if(n < 0)
+		return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+	if(n == 0)
+		return -1;
+
+	c->req_len += n;
+	c->req[c->req_len] = '\0';
+
+	if(strstr(c->req, "\r\n\r\n") != NULL || strstr(c->req, "\n\n") != NULL)
+		return conn_respond(c, st);
+
+	return c->req_len == sizeof(c->req) - 1 ? -1 : 0;
+}
+
+/* Output:
+ *	1 once the response is sent, 0 if more is to be sent, -1 on error
+ */
+static int conn_output(struct ex_conn *c) {
+	ssize_t n;
+
+	while(c->out_off < c->out_len) {
+		n = send(c->fd, c->out + c->out_off, c->out_len - c->out_off, MSG_NOSIGNAL);
+		if(n < 0)
+			return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+		c->out_off += n;
+	}
+
+	return 1;
+}
+
+static void conn_close(int i) {
+	close(conns[i].fd);
+	free(conns[i].out);
+	conns[i] = conns[--num_conns];
+}
+
+static void exporter_accept(int lfd, struct ex_stats *st) {
+	struct ex_conn *c;
+	int fd;
+
+	while((fd = accept(lfd, NULL, NULL)) >= 0) {
+		if(num_conns == EX_MAX_CLIENTS) {
+			st->rejected++;
+			close(fd);
+			continue;
+		}
+
+		fcntl(fd, F_SETFL, O_NONBLOCK);
+		fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+		c = &conns[num_conns++];
+		memset(c, 0, sizeof(*c));
+		c->fd = fd;
+
+		// a Unix socket connection gets the page right away
+		if(!http && conn_respond(c, st) == -1)
+			conn_close(num_conns - 1);
+	}
+}
+
+/*
+ * Serves the metrics until SIGINT or SIGTERM
+ * Input:
+ *	const char *endpoint		- TCP address or Unix socket path
+ *	const struct reg_registry *rr	- registry of the detected family
+ *	int interval_ms			- sampling period
+ *	int argc, char **argv		- register patterns, every register if none
+ *
+ * Output:
+ *	exit status of the program
+ */
+int run_exporter(const char *endpoint, const struct reg_registry *rr, int interval_ms,
+		 int argc, char **argv) {
+	struct pollfd pfds[EX_MAX_CLIENTS + 1];
+	struct ex_stats st;
+	struct read_plan plan;
+	struct sigaction sa;
+	uint64_t now, start, next_sample;
+	uint32_t *values;
+	int *indices;
+	int lfd, i, n, num_regs, timeout;
+
+	if((indices = malloc(rr->count * sizeof(int))) == NULL) FATAL;
+	if((values = malloc(rr->count * sizeof(uint32_t))) == NULL) FATAL;
+
+	num_regs = registry_select(rr, argc, argv, indices);
+	if(num_regs == 0) {
+		free(indices);
+		free(values);
+		return 1;
+	}
+
+	if(plan_build(&plan, rr, indices, num_regs) == -1) FATAL;
+
+	http = !net_is_unix(endpoint);
+	if((lfd = net_listen(endpoint)) == -1) FATAL;
+	printf("exporting %d registers every %d ms on %s\n", num_regs, interval_ms, endpoint);
+	fflush(stdout);
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = exporter_signal;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	memset(&st, 0, sizeof(st));
+	next_sample = now_ns();
+
+	while(!exporter_quit) {
+		now = now_ns();
+		if(now >= next_sample) {
+			start = now;
+			plan_run(&plan, values);
+			now = now_ns();
+
+			st.samples++;
+			st.last_read_ns = now - start;
+			st.read_ns += st.last_read_ns;
+			exporter_render(rr, indices, num_regs, values, &st);
+
+			next_sample += interval_ms * 1000000ULL;
+			if(next_sample <= now) {
+				if(st.samples > 1)
+					st.overruns++;
+				next_sample = now + interval_ms * 1000000ULL;
+			}
+		}
+		timeout = (next_sample - now + 999999) / 1000000;
+
+		pfds[0].fd = lfd;
+		pfds[0].events = POLLIN;
+		for(i = 0; i < num_conns; i++) {
+			pfds[i + 1].fd = conns[i].fd;
+			pfds[i + 1].events = conns[i].out ? POLLOUT : POLLIN;
+		}
+
+		n = num_conns;
+		if(poll(pfds, n + 1, timeout) == -1) {
+			if(errno == EINTR)
+				continue;
+			FATAL;
+		}
+
+		// walk backwards, conn_close() moves the last connection into the hole
+		for(i = n - 1; i >= 0; i--) {
+			struct ex_conn *c = &conns[i];
+			short ev = pfds[i + 1].revents;
+			int ret = 0;
+
+			if(ev & (POLLERR | POLLNVAL))
+				ret = -1;
+			if(ret == 0 && c->out == NULL && (ev & (POLLIN | POLLHUP)))
+				ret = conn_input(c, &st);
+			if(ret == 0 && c->out != NULL)
+				ret = conn_output(c);
+
+			if(ret != 0)
+				conn_close(i);
+		}
+
+		if(pfds[0].revents & POLLIN)
+			exporter_accept(lfd, &st);
+	}
+
+	while(num_conns > 0)
+		conn_close(num_conns - 1);
+
+	close(lfd);
+	net_unlink(endpoint);
+	plan_free(&plan);
+	free(indices);
+	free(values);
+	free(page);
+	mem_close();
+
+	return 0;
+}
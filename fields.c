@@ -0,0 +1,184 @@
+/*
+ * fields.c : bitfields of the registers and their decoding
+ *
+ * The fields of the registers are part of the family descriptions (field and
+ * enum records, see desc.c), from which the tables are generated with
+ * regtab.awk: the third member of struct reg_info. Registers without fields
+ * are shown as raw values only.
+ *
+ * Sampling never looks at the fields: a value is decoded only when it is
+ * printed, by reg_decode(). The write mode looks fields up by name to change
+ * them (reg_find_field(), reg_field_value()).
+ *
+ * Status registers take the same few values over and over while they are
+ * watched or captured, so reg_decode_cached() keeps the rendered text in a
+ * direct-mapped cache keyed by register and value. A register shared by
+ * several instances shares its entries too, the text does not depend on the
+ * instance. The cache is not locked, it is used by single threaded outputs.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+
+#include "devicedbg.h"
+
+#define DECODE_CACHE_BITS	10	/* 1024 entries */
+#define DECODE_TEXT		256
+
+struct decode_entry {
+	const struct reg_info *reg;	/* NULL while unused */
+	uint32_t value;
+	char text[DECODE_TEXT];
+};
+
+static struct decode_entry decode_cache[1 << DECODE_CACHE_BITS];
+static uint64_t decode_hits, decode_misses;
+
+/*
+ * Decodes the fields of a register value
+ * Input:
+ *	const struct reg_info *reg	- register, its fields may be NULL
+ *	uint32_t value			- raw value
+ *	char *buf, size_t size		- receives " [FIELD ...]"; single bit fields
+ *					  are listed when set, wider ones as
+ *					  NAME=value or NAME=ENUM
+ *
+ * Output:
+ *	length of the text, 0 (empty buf) if the register has no fields or
+ *	only single bit fields, all clear
+ */
+int reg_decode(const struct reg_info *reg, uint32_t value, char *buf, size_t size) {
+	const struct reg_field *f;
+	const struct reg_enum *e;
+	uint32_t v;
+	size_t len = 0;
+
+	if(size > 0)
+		buf[0] = '\0';
+	if(reg->fields == NULL || size < 4)
+		return 0;
+
+	len = snprintf(buf, size, " [");
+
+	for(f = reg->fields; f->name != NULL && len < size; f++) {
+		v = (value >> f->shift) & (f->width == 32 ? ~0U : (1U << f->width) - 1);
+
+		if(f->width == 1) {
+			if(v)
+				len += snprintf(buf + len, size - len, "%s%s", len > 2 ? " " : "", f->name);
+			continue;
+		}
+
+		for(e = f->values; e != NULL && e->name != NULL && e->value != v; e++)
+			;
+		if(e != NULL && e->name != NULL)
+			len += snprintf(buf + len, size - len, "%s%s=%s", len > 2 ? " " : "",
+					f->name, e->name);
+		else
+			len += snprintf(buf + len, size - len, "%s%s=%u", len > 2 ? " " : "",
+					f->name, v);
+	}
+
+	if(len == 2) {
+		buf[0] = '\0';
+		return 0;
+	}
+
+	if(len < size)
+		len += snprintf(buf + len, size - len, "]");
+	if(len >= size)
+		len = size - 1;
+	return len;
+}
+
+/*
+ * Decodes the fields of a register value through the decode cache
+ * Input:
+ *	const struct reg_info *reg	- register, its fields may be NULL
+ *	uint32_t value			- raw value
+ *
+ * Output:
+ *	text as for reg_decode(), valid until the next call
+ */
+const char *reg_decode_cached(const struct reg_info *reg, uint32_t value) {
+	struct decode_entry *e;
+	uint32_t h;
+
+	if(reg->fields == NULL)
+		return "";
+
+	h = ((uint32_t) (uintptr_t) reg ^ value * 0x9E3779B1U) * 0x85EBCA6BU;
+	e = &decode_cache[h >> (32 - DECODE_CACHE_BITS)];
+
+	if(e->reg == reg && e->value == value) {
+		decode_hits++;
+		return e->text;
+	}
+
+	decode_misses++;
+	e->reg = reg;
+	e->value = value;
+	reg_decode(reg, value, e->text, sizeof(e->text));
+	return e->text;
+}
+
+/* Lookups of the decode cache answered without decoding, and the others */
+void reg_decode_stats(uint64_t *hits, uint64_t *misses) {
+	*hits = decode_hits;
+	*misses = decode_misses;
+}
+
+/*
+ * Finds a field of a register by name, ignoring case
+ * Output:
+ *	the field, NULL if the register has none of that name
+ */
+const struct reg_field *reg_find_field(const struct reg_info *reg, const char *name) {
+	const struct reg_field *f;
+
+	for(f = reg->fields; f != NULL && f->name != NULL; f++) {
+		if(strcasecmp(f->name, name) == 0)
+			return f;
+	}
+	return NULL;
+}
+
+/* Bits of a field in its register */
+uint32_t reg_field_mask(const struct reg_field *f) {
+	return (f->width == 32 ? ~0U : (1U << f->width) - 1) << f->shift;
+}
+
+/*
+ * Parses a value of a field, a number or the name of one of its values
+ * Input:
+ *	const struct reg_field *f	- field
+ *	const char *arg			- "3", "0x3" or "8BITS"
+ *	uint32_t *value			- receives the value in place in the register
+ *
+ * Output:
+ *	0 on success, -1 if the value is unknown or wider than the field
+ */
+int reg_field_value(const struct reg_field *f, const char *arg, uint32_t *value) {
+	const struct reg_enum *e;
+	unsigned long v;
+	char *end;
+
+	for(e = f->values; e != NULL && e->name != NULL; e++) {
+		if(strcasecmp(e->name, arg) == 0) {
+			*value = e->value << f->shift;
+			return 0;
+		}
+	}
+
+	errno = 0;
+	v = strtoul(arg, &end, 0);
+	if(errno != 0 || end == arg || *end != '\0' || (f->width < 32 && v >> f->width) != 0 ||
+	   v > UINT32_MAX)
+		return -1;
+
+	*value = (uint32_t) v << f->shift;
+	return 0;
+}
@@ -0,0 +1,245 @@
+/*
+ * golden.c : comparison of a live board with a golden reference
+ *
+ * A golden reference is a text file of the expected value of the registers
+ * of a known-good board, each with the mask of the bits to ignore:
+ *
+ *	# family AM335x
+ *	UART1.MDR1 0x00000007 0x00000000
+ *	TIMER2.TCRR 0x0002A8C1 0xFFFFFFFF
+ *
+ * When recording a reference the masks come from the defaults of the family
+ * tables (struct reg_mask), and can be edited afterwards. Registers missing
+ * from the file are not compared.
+ *
+ * The check reads every register in one pass of a read plan, then compares
+ * the whole SoC with a masked XOR four registers at a time, and only looks
+ * at the individual registers when that pass found a deviation. Registers of
+ * modules which are not available read 0, they deviate as not available.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "devicedbg.h"
+
+/* Default ignore masks of the registry, from the family tables, the registers
+ * the plans do not read are ignored whole */
+static void golden_default_masks(const struct reg_registry *rr, uint32_t *ignore, int *indices) {
+	const struct soc_tables *tables = family_tables(rr->family);
+	int m, i, n;
+
+	for(i = 0; i < rr->count; i++)
+		ignore[i] = plan_readable(rr->entries[i].reg) ? 0 : 0xFFFFFFFF;
+
+	for(m = 0; m < tables->num_masks; m++) {
+		n = registry_match(rr, tables->masks[m].pattern, indices);
+		for(i = 0; i < n; i++)
+			ignore[indices[i]] |= tables->masks[m].ignore;
+	}
+}
+
+/*
+ * Masked compare of two register vectors
+ * Input:
+ *	const uint32_t *live, *golden	- values
+ *	const uint32_t *care		- bits to compare
+ *	int n				- number of registers
+ *
+ * Output:
+ *	OR of the deviating bits of all the registers, 0 if they all match
+ */
+static uint32_t golden_compare(const uint32_t *live, const uint32_t *golden,
+			       const uint32_t *care, int n) {
+	dd_v4 acc = { 0, 0, 0, 0 }, a, b, m;
+	uint32_t dev;
+	int i;
+
+	for(i = 0; i + 4 <= n; i += 4) {
+		memcpy(&a, live + i, sizeof(a));
+		memcpy(&b, golden + i, sizeof(b));
+		memcpy(&m, care + i, sizeof(m));
+		acc |= (a ^ b) & m;
+	}
+
+	dev = acc[0] | acc[1] | acc[2] | acc[3];
+	for(; i < n; i++)
+		dev |= (live[i] ^ golden[i]) & care[i];
+
+	return dev;
+}
+
+/* Loads a golden reference in registry order, care[] is 0 for the registers it lacks
+ * Output:
+ *	0 on success, -1 on error, the reason is printed
+ */
+static int golden_load(const char *path, const struct reg_registry *rr,
+		       uint32_t *golden, uint32_t *care) {
+	char line[256], name[REG_NAME_LEN], family[32], *sep, *end;
+	unsigned long value, ignore;
+	int lineno = 0, idx;
+	FILE *f;
+
+	if((f = fopen(path, "r")) == NULL) {
+		fprintf(stderr, "devicedbg: %s: %s\n", path, strerror(errno));
+		return -1;
+	}
+
+	memset(golden, 0, rr->count * sizeof(uint32_t));
+	memset(care, 0, rr->count * sizeof(uint32_t));
+
+	while(fgets(line, sizeof(line), f) != NULL) {
+		lineno++;
+
+		if(sscanf(line, "# family %31s", family) == 1 &&
+		   strcasecmp(family, rr->family->name) != 0) {
+			fprintf(stderr, "devicedbg: %s is a reference of %s\n", path, family);
+			goto fail;
+		}
+
+		if(line[0] == '#' || line[0] == '\n')
+			continue;
+
+		// names may hold spaces, the value and the mask are the last two fields
+		line[strcspn(line, "\n")] = '\0';
+		if((end = strrchr(line, ' ')) == NULL || end == line ||
+		   (*end = '\0', (sep = strrchr(line, ' ')) == NULL) ||
+		   sep - line >= REG_NAME_LEN ||
+		   sscanf(sep + 1, "%lx", &value) != 1 || sscanf(end + 1, "%lx", &ignore) != 1) {
+			fprintf(stderr, "devicedbg: %s:%d: malformed line\n", path, lineno);
+			goto fail;
+		}
+		memcpy(name, line, sep - line);
+		name[sep - line] = '\0';
+
+		if((idx = registry_lookup(rr, name)) < 0) {
+			fprintf(stderr, "devicedbg: %s:%d: unknown register %s\n", path, lineno, name);
+			goto fail;
+		}
+
+		golden[idx] = value;
+		care[idx] = ~ignore;
+	}
+
+	fclose(f);
+	return 0;
+
+fail:
+	fclose(f);
+	return -1;
+}
+
+/*
+ * Records the registers of the board as a golden reference
+ * Input:
+ *	const char *path		- reference file to write
+ *	const struct reg_registry *rr	- registry of the detected family
+ *
+ * Output:
+ *	exit status of the program
+ */
+int run_golden_record(const char *path, const struct reg_registry *rr) {
+	struct read_plan plan;
+	uint32_t *values, *ignore;
+	char qname[REG_NAME_LEN];
+	int *indices, i;
+	FILE *f;
+
+	values = malloc(rr->count * sizeof(uint32_t));
+	ignore = malloc(rr->count * sizeof(uint32_t));
+	indices = malloc(rr->count * sizeof(int));
+	if(values == NULL || ignore == NULL || indices == NULL) FATAL;
+
+	if(plan_build_all(&plan, rr) == -1) FATAL;
+	plan_run(&plan, values);
+	plan_free(&plan);
+
+	golden_default_masks(rr, ignore, indices);
+
+	if((f = fopen(path, "w")) == NULL) {
+		fprintf(stderr, "devicedbg: %s: %s\n", path, strerror(errno));
+		return 1;
+	}
+
+	fprintf(f, "# devicedbg golden reference\n# family %s\n# table hash %08X\n"
+		"# register, value, bits to ignore\n", rr->family->name, rr->hash);
+	for(i = 0; i < rr->count; i++)
+		fprintf(f, "%s 0x%08X 0x%08X\n", reg_entry_name(&rr->entries[i], qname),
+			values[i], ignore[i]);
+
+	if(fclose(f) == EOF) {
+		fprintf(stderr, "devicedbg: %s: %s\n", path, strerror(errno));
+		return 1;
+	}
+
+	printf("%d registers recorded in %s\n", rr->count, path);
+
+	free(values);
+	free(ignore);
+	free(indices);
+	return 0;
+}
+
+/*
+ * Compares the board with a golden reference
+ * Input:
+ *	const char *path		- reference file
+ *	const struct reg_registry *rr	- registry of the detected family
+ *
+ * Output:
+ *	exit status of the program: 0 if the board matches, 2 if it deviates
+ */
+int run_golden_check(const char *path, const struct reg_registry *rr) {
+	struct read_plan plan;
+	uint32_t *values, *golden, *care, dev;
+	char fields[256], qname[REG_NAME_LEN];
+	uint64_t elapsed;
+	int i, n = 0;
+
+	values = malloc(rr->count * sizeof(uint32_t));
+	golden = malloc(rr->count * sizeof(uint32_t));
+	care = malloc(rr->count * sizeof(uint32_t));
+	if(values == NULL || golden == NULL || care == NULL) FATAL;
+
+	if(golden_load(path, rr, golden, care) == -1)
+		return 1;
+
+	if(plan_build_all(&plan, rr) == -1) FATAL;
+
+	elapsed = now_ns();
+	plan_run(&plan, values);
+	dev = golden_compare(values, golden, care, rr->count);
+	elapsed = now_ns() - elapsed;
+
+	// a register read as 0 may match the reference, its module deviates anyway
+	for(i = 0; i < rr->count; i++)
+		dev |= rr->absent[i] && care[i];
+
+	for(i = 0; dev != 0 && i < rr->count; i++) {
+		if(rr->absent[i] && care[i]) {
+			printf("%-32s 0x%08lX: module not available, expected 0x%08X\n",
+			       reg_entry_name(&rr->entries[i], qname), rr->entries[i].addr, golden[i]);
+			n++;
+			continue;
+		}
+		if(((values[i] ^ golden[i]) & care[i]) == 0)
+			continue;
+
+		reg_decode(rr->entries[i].reg, values[i], fields, sizeof(fields));
+		printf("%-32s 0x%08lX: 0x%08X expected 0x%08X, bits 0x%08X differ%s\n",
+		       reg_entry_name(&rr->entries[i], qname), rr->entries[i].addr, values[i],
+		       golden[i], (values[i] ^ golden[i]) & care[i], fields);
+		n++;
+	}
+
+	printf("%s: %d of %d registers deviate from %s (%.1f us)\n", n ? "FAIL" : "OK",
+	       n, rr->count, path, elapsed / 1e3);
+
+	plan_free(&plan);
+	free(values);
+	free(golden);
+	free(care);
+	return n ? 2 : 0;
+}
@@ -0,0 +1,198 @@
+/*
+ * mem.c : access to the physical memory through "/dev/mem"
+ *
+ * Pages are mapped on first use and kept in a small cache sorted by physical
+ * page address, so long running modes (the daemon) map every page only once.
+ * The backing file can be changed with mem_set_path(): any regular file
+ * (e.g. a sparse image made with 'truncate -s 2G regs.img') can stand in for
+ * "/dev/mem", which lets everything run without the hardware.
+ *
+ * Reading a module whose clock is gated raises a bus error. Accesses made
+ * under mem_guard() recover from it: the SIGBUS handler jumps back to the
+ * sigsetjmp() of the armed buffer of the thread, and mem_fault_addr() tells
+ * which address faulted. Past the end of a memory file gives the same fault.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <setjmp.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/mman.h>
+
+#include "devicedbg.h"
+
+struct mem_map {
+	unsigned long page;
+	void *virt;
+};
+
+static const char *mem_path = MEM_FILE;
+static int mem_fd = -1;
+
+static struct mem_map *maps;
+static int num_maps;
+static int max_maps;
+
+static __thread sigjmp_buf *mem_guard_env;	/* armed recovery of the thread */
+static __thread void *mem_fault;
+
+/* Selects the file used instead of "/dev/mem", must be called before any access */
+void mem_set_path(const char *path) {
+	mem_path = path;
+}
+
+const char *mem_get_path(void) {
+	return mem_path;
+}
+
+static void mem_sigbus(int sig, siginfo_t *si, void *context) {
+	sigjmp_buf *env = mem_guard_env;
+
+	// not a guarded access: the fault happens again and is fatal
+	if(env == NULL) {
+		signal(SIGBUS, SIG_DFL);
+		return;
+	}
+
+	mem_fault = si->si_addr;
+	siglongjmp(*env, 1);
+}
+
+/* Opens the memory file once, and installs the bus error recovery */
+static void mem_open(void) {
+	struct sigaction sa;
+
+	if(mem_fd != -1)
+		return;
+
+	if((mem_fd = open(mem_path, O_RDWR | O_SYNC)) == -1) FATAL;
+
+	// SIGBUS is left unblocked on the way out of the handler, as sigsetjmp(env, 0)
+	// does not restore the signal mask
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_sigaction = mem_sigbus;
+	sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+	sigaction(SIGBUS, &sa, NULL);
+}
+
+/* index of the first cached mapping whose page is >= page */
+static int mem_lookup(unsigned long page) {
+	int lo = 0, hi = num_maps;
+
+	while(lo < hi) {
+		int mid = (lo + hi) / 2;
+
+		if(maps[mid].page < page)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+/*
+ * Returns the virtual address of a physical address
+ * Input:
+ *	unsigned long phys - physical address
+ *
+ * Output:
+ *	virtual address, the page holding it is mapped on first use
+ */
+void *mem_map(unsigned long phys) {
+	unsigned long page = phys & ~MAP_MASK;
+	void *virt;
+	int i;
+
+	i = mem_lookup(page);
+	if(i < num_maps && maps[i].page == page)
+		return maps[i].virt + (phys & MAP_MASK);
+
+	mem_open();
+	virt = mmap(0, MAP_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, mem_fd, page);
+	if(virt == (void *) -1) FATAL;
+
+	if(num_maps == max_maps) {
+		max_maps = max_maps ? max_maps * 2 : 32;
+		maps = realloc(maps, max_maps * sizeof(*maps));
+		if(maps == NULL) FATAL;
+	}
+
+	memmove(&maps[i + 1], &maps[i], (num_maps - i) * sizeof(*maps));
+	maps[i].page = page;
+	maps[i].virt = virt;
+	num_maps++;
+
+	return virt + (phys & MAP_MASK);
+}
+
+/* Reads a 32-bit register */
+uint32_t mem_read32(unsigned long phys) {
+	return *(volatile uint32_t *) mem_map(phys);
+}
+
+/*
+ * Arms the bus error recovery of the calling thread
+ * Input:
+ *	sigjmp_buf *env - filled by sigsetjmp(*env, 0) right after, NULL disarms
+ *
+ * Output:
+ *	buffer armed before, to be restored when the guarded accesses are done
+ */
+sigjmp_buf *mem_guard(sigjmp_buf *env) {
+	sigjmp_buf *prev = mem_guard_env;
+
+	mem_guard_env = env;
+	return prev;
+}
+
+/* Address of the last bus error caught in the calling thread */
+void *mem_fault_addr(void) {
+	return mem_fault;
+}
+
+/*
+ * Reads a 32-bit register, surviving a bus error
+ * Output:
+ *	0 and the value, -1 if the access faults (module not clocked)
+ */
+int mem_try_read32(unsigned long phys, uint32_t *value) {
+	volatile uint32_t *virt = mem_map(phys);
+	sigjmp_buf env, *prev;
+	int ret = 0;
+
+	prev = mem_guard(&env);
+	if(sigsetjmp(env, 0) == 0)
+		*value = *virt;
+	else
+		ret = -1;
+	mem_guard(prev);
+
+	return ret;
+}
+
+/* Number of pages currently mapped */
+int mem_num_maps(void) {
+	return num_maps;
+}
+
+/* Drops all the mappings and closes the memory file */
+void mem_close(void) {
+	int i;
+
+	for(i = 0; i < num_maps; i++)
+		munmap(maps[i].virt, MAP_SIZE);
+
+	free(maps);
+	maps = NULL;
+	num_maps = max_maps = 0;
+
+	if(mem_fd != -1)
+		close(mem_fd);
+	mem_fd = -1;
+}
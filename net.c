@@ -0,0 +1,245 @@
+/*
+ * net.c : endpoints of the daemon, the exporter and their clients
+ *
+ * An endpoint containing a '/' is a Unix socket path, "host:port" a TCP
+ * address and a bare number a TCP port on the loopback interface, so that a
+ * board is only reachable from the network when asked for explicitly, e.g.
+ * "0.0.0.0:7000".
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+
+#include "devicedbg.h"
+
+int net_is_unix(const char *endpoint) {
+	return strchr(endpoint, '/') != NULL;
+}
+
+/*
+ * Endpoint of the n-th of consecutive agents started from one endpoint: the
+ * port is incremented, a Unix socket path gets a ".n" suffix
+ */
+void net_endpoint_nth(char *buf, size_t size, const char *endpoint, int n) {
+	const char *colon = strrchr(endpoint, ':');
+
+	if(n == 0)
+		snprintf(buf, size, "%s", endpoint);
+	else if(net_is_unix(endpoint))
+		snprintf(buf, size, "%s.%d", endpoint, n);
+	else if(colon == NULL)
+		snprintf(buf, size, "%d", atoi(endpoint) + n);
+	else
+		snprintf(buf, size, "%.*s:%d", (int) (colon - endpoint), endpoint, atoi(colon + 1) + n);
+}
+
+/* Resolves a TCP endpoint
+ * Output:
+ *	address list to be freed with freeaddrinfo() or NULL, the reason is printed
+ */
+static struct addrinfo *net_resolve(const char *endpoint, int passive) {
+	struct addrinfo hints, *ai;
+	char host[256];
+	const char *port, *colon;
+	int err;
+
+	if((colon = strrchr(endpoint, ':')) == NULL) {
+		strcpy(host, "127.0.0.1");
+		port = endpoint;
+	}
+	else {
+		if(colon - endpoint >= sizeof(host)) {
+			fprintf(stderr, "devicedbg: bad endpoint %s\n", endpoint);
+			return NULL;
+		}
+		memcpy(host, endpoint, colon - endpoint);
+		host[colon - endpoint] = '\0';
+		port = colon + 1;
+	}
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = passive ? AI_PASSIVE : 0;
+
+	if((err = getaddrinfo(host, port, &hints, &ai)) != 0) {
+		fprintf(stderr, "devicedbg: %s: %s\n", endpoint, gai_strerror(err));
+		return NULL;
+	}
+
+	return ai;
+}
+
+static int net_unix_addr(const char *path, struct sockaddr_un *addr) {
+	if(strlen(path) >= sizeof(addr->sun_path)) {
+		fprintf(stderr, "devicedbg: socket path too long: %s\n", path);
+		return -1;
+	}
+
+	memset(addr, 0, sizeof(*addr));
+	addr->sun_family = AF_UNIX;
+	strcpy(addr->sun_path, path);
+	return 0;
+}
+
+/* Disables Nagle on TCP sockets, requests and replies are small and pipelined */
+void net_nodelay(int fd) {
+	int one = 1;
+
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+/*
+ * Frees a Unix socket path for a new listener: a socket nobody listens on
+ * any more is removed, anything else is left alone, so that a mistyped path
+ * or a second daemon on the same socket is reported instead
+ * Output:
+ *	0 if the path is free, -1 otherwise, the reason is printed
+ */
+static int net_unix_reclaim(const char *endpoint, const struct sockaddr_un *addr) {
+	struct stat st;
+	int fd, ret;
+
+	if(lstat(endpoint, &st) == -1)
+		return errno == ENOENT ? 0 : -1;
+
+	if(!S_ISSOCK(st.st_mode)) {
+		fprintf(stderr, "devicedbg: %s exists and is not a socket, not replaced\n", endpoint);
+		errno = EEXIST;
+		return -1;
+	}
+
+	if((fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) == -1)
+		return -1;
+	ret = connect(fd, (const struct sockaddr *) addr, sizeof(*addr));
+	close(fd);
+
+	if(ret == 0) {
+		fprintf(stderr, "devicedbg: %s is in use by another process\n", endpoint);
+		errno = EADDRINUSE;
+		return -1;
+	}
+	if(errno != ECONNREFUSED)
+		return -1;
+
+	return unlink(endpoint);
+}
+
+/* Removes the socket of a Unix endpoint on exit, if it still is one */
+void net_unlink(const char *endpoint) {
+	struct stat st;
+
+	if(net_is_unix(endpoint) && lstat(endpoint, &st) == 0 && S_ISSOCK(st.st_mode))
+		unlink(endpoint);
+}
+
+/* Opens a non-blocking listening socket
+ * Output:
+ *	socket or -1
+ */
+int net_listen(const char *endpoint) {
+	struct sockaddr_un addr;
+	struct addrinfo *ai;
+	int fd, one = 1;
+
+	if(net_is_unix(endpoint)) {
+		if(net_unix_addr(endpoint, &addr) == -1)
+			return -1;
+
+		if((fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) == -1)
+			return -1;
+
+		if(net_unix_reclaim(endpoint, &addr) == -1 ||
+		   bind(fd, (struct sockaddr *) &addr, sizeof(addr)) == -1 ||
+		   listen(fd, SOMAXCONN) == -1) {
+			close(fd);
+			return -1;
+		}
+
+		return fd;
+	}
+
+	if((ai = net_resolve(endpoint, 1)) == NULL)
+		return -1;
+
+	if((fd = socket(ai->ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) == -1) {
+		freeaddrinfo(ai);
+		return -1;
+	}
+
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+	if(bind(fd, ai->ai_addr, ai->ai_addrlen) == -1 || listen(fd, SOMAXCONN) == -1) {
+		close(fd);
+		freeaddrinfo(ai);
+		return -1;
+	}
+
+	freeaddrinfo(ai);
+	return fd;
+}
+
+/*
+ * Connects to an endpoint
+ * Input:
+ *	const char *endpoint	- Unix socket path or TCP address
+ *	int nonblock		- return while the connection is in progress
+ *
+ * Output:
+ *	socket or -1 with errno set; a non-blocking socket is writable once
+ *	connected, SO_ERROR then tells whether it succeeded
+ */
+int net_connect(const char *endpoint, int nonblock) {
+	struct sockaddr_un addr;
+	struct addrinfo *ai;
+	int fd, flags = SOCK_CLOEXEC | (nonblock ? SOCK_NONBLOCK : 0);
+
+	if(net_is_unix(endpoint)) {
+		if(net_unix_addr(endpoint, &addr) == -1) {
+			errno = ENAMETOOLONG;
+			return -1;
+		}
+
+		if((fd = socket(AF_UNIX, SOCK_STREAM | flags, 0)) == -1)
+			return -1;
+
+		if(connect(fd, (struct sockaddr *) &addr, sizeof(addr)) == -1 && errno != EINPROGRESS) {
+			close(fd);
+			return -1;
+		}
+
+		return fd;
+	}
+
+	if((ai = net_resolve(endpoint, 0)) == NULL) {
+		errno = EHOSTUNREACH;
+		return -1;
+	}
+
+	if((fd = socket(ai->ai_family, SOCK_STREAM | flags, 0)) == -1) {
+		freeaddrinfo(ai);
+		return -1;
+	}
+
+	net_nodelay(fd);
+	if(connect(fd, ai->ai_addr, ai->ai_addrlen) == -1 && errno != EINPROGRESS) {
+		int err = errno;
+
+		close(fd);
+		freeaddrinfo(ai);
+		errno = err;
+		return -1;
+	}
+
+	freeaddrinfo(ai);
+	return fd;
+}
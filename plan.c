@@ -0,0 +1,271 @@
+/*
+ * plan.c : read plans, one pass over the cached mappings for a set of registers
+ *
+ * A plan is built once for a list of registry entries: the virtual address of
+ * every register is resolved through the mapping cache and the accesses are
+ * sorted by physical address, so running the plan walks the pages in order
+ * and reads a register asked for several times only once. The values are
+ * stored back in request order.
+ *
+ * The registers of absent modules (see avail.c) are not read, they give 0. A
+ * run is guarded against bus errors: a module that faults is marked absent,
+ * dropped from the plan, and the run goes on with the next register.
+ *
+ * The slots are grouped in runs on one instance (struct plan_module). A run
+ * starts with one pass over the module state registers of those instances
+ * (struct reg_instance), each read once, and the modules whose clock is off
+ * give 0 without being touched.
+ *
+ * Registers with side effects on read (struct reg_info access) are not read
+ * and give 0: a FIFO or a status register cleared by reading would lose the
+ * data of the driver at every sample. plan_set_access() lets the read-clears
+ * and FIFO registers be read, write-only registers are never read. All the
+ * other registers can be read in any order and any number of times, the
+ * slots at consecutive words of a module are read as one burst, without the
+ * per-register checks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+
+#include "devicedbg.h"
+
+static int plan_destructive;
+static const struct reg_registry *sort_registry;
+static const int *sort_indices;
+
+static int plan_cmp(const void *a, const void *b) {
+	int x = *(const int *) a, y = *(const int *) b;
+	unsigned long ax = sort_registry->entries[sort_indices[x]].addr;
+	unsigned long ay = sort_registry->entries[sort_indices[y]].addr;
+
+	if(ax != ay)
+		return ax < ay ? -1 : 1;
+	return x - y;
+}
+
+/* Lets the plans read the registers whose read clears status bits or pops a FIFO */
+void plan_set_access(int destructive) {
+	plan_destructive = destructive;
+}
+
+/*
+ * Tells whether the plans read a register
+ * Output:
+ *	1 if it is read, 0 if reading it would have side effects
+ */
+int plan_readable(const struct reg_info *reg) {
+	return reg->access == REG_READ_SAFE ||
+	       (plan_destructive && reg->access != REG_WRITE_ONLY);
+}
+
+/* Index of the module state register of an instance in a plan, -1 if it has none */
+static int plan_clock(struct read_plan *plan, const struct reg_instance *instance) {
+	volatile uint32_t *virt;
+	int c;
+
+	if(instance->clock == 0)
+		return -1;
+
+	virt = mem_map(instance->clock);
+	for(c = 0; c < plan->num_clocks && plan->clocks[c] != virt; c++)
+		;
+	if(c == plan->num_clocks)
+		plan->clocks[plan->num_clocks++] = virt;
+
+	return c;
+}
+
+/*
+ * Builds a read plan
+ * Input:
+ *	struct read_plan *plan		- plan to fill
+ *	const struct reg_registry *rr	- registry the indices refer to
+ *	const int *indices, int n	- registry indices in request order
+ *
+ * Output:
+ *	0 on success, -1 on allocation failure
+ */
+int plan_build(struct read_plan *plan, const struct reg_registry *rr, const int *indices, int n) {
+	const struct reg_instance *instance;
+	struct plan_module *m = NULL;
+	int i;
+
+	// there are at most as many modules and clocks as slots
+	memset(plan, 0, sizeof(*plan));
+	plan->n = n;
+	plan->rr = rr;
+	plan->order = malloc((n ? n : 1) * sizeof(int));
+	plan->virt = malloc((n ? n : 1) * sizeof(volatile uint32_t *));
+	plan->entry = malloc((n ? n : 1) * sizeof(int));
+	plan->burst = malloc((n ? n : 1) * sizeof(int));
+	plan->modules = malloc((n ? n : 1) * sizeof(struct plan_module));
+	plan->clocks = malloc((n ? n : 1) * sizeof(volatile uint32_t *));
+	plan->clock_values = malloc((n ? n : 1) * sizeof(uint32_t));
+	if(plan->order == NULL || plan->virt == NULL || plan->entry == NULL || plan->burst == NULL ||
+	   plan->modules == NULL || plan->clocks == NULL || plan->clock_values == NULL) {
+		plan_free(plan);
+		return -1;
+	}
+
+	for(i = 0; i < n; i++)
+		plan->order[i] = i;
+
+	sort_registry = rr;
+	sort_indices = indices;
+	qsort(plan->order, n, sizeof(int), plan_cmp);
+
+	for(i = 0; i < n; i++) {
+		plan->entry[i] = indices[plan->order[i]];
+		plan->virt[i] = rr->absent[plan->entry[i]] ||
+				!plan_readable(rr->entries[plan->entry[i]].reg) ? NULL :
+				mem_map(rr->entries[plan->entry[i]].addr);
+
+		instance = rr->entries[plan->entry[i]].instance;
+		if(m == NULL || instance != rr->entries[plan->entry[m->start]].instance) {
+			m = &plan->modules[plan->num_modules++];
+			m->start = i;
+			m->clock = plan_clock(plan, instance);
+			m->clock_off = instance->clock_off;
+		}
+		m->end = i + 1;
+	}
+
+	// bursts stay in a module and in a mapping
+	for(m = plan->modules; m < plan->modules + plan->num_modules; m++) {
+		for(i = m->end - 1; i >= m->start; i--) {
+			plan->burst[i] = plan->virt[i] == NULL ? 0 :
+					 i + 1 < m->end && plan->virt[i + 1] == plan->virt[i] + 1 ?
+					 plan->burst[i + 1] + 1 : 1;
+		}
+	}
+
+	return 0;
+}
+
+/* Plan over every register of the registry, values come out in registry order */
+int plan_build_all(struct read_plan *plan, const struct reg_registry *rr) {
+	int *indices, i, ret;
+
+	if((indices = malloc((rr->count ? rr->count : 1) * sizeof(int))) == NULL)
+		return -1;
+
+	for(i = 0; i < rr->count; i++)
+		indices[i] = i;
+
+	ret = plan_build(plan, rr, indices, rr->count);
+	free(indices);
+	return ret;
+}
+
+/* Reads the module state registers of a plan, an unreadable one counts as clocked */
+static void plan_run_clocks(const struct read_plan *plan) {
+	int c;
+
+	for(c = 0; c < plan->num_clocks; c++)
+		plan->clock_values[c] = plan->clocks[c] != NULL ? *plan->clocks[c] : 0;
+}
+
+/* Reads the slots of a plan from start on */
+static void plan_run_from(const struct read_plan *plan, uint32_t *values, int start) {
+	const struct plan_module *m = plan->modules;
+	volatile uint32_t *last;
+	uint32_t v = 0;
+	int i = start, k, n;
+
+	for(; m < plan->modules + plan->num_modules && m->end <= start; m++)
+		;
+
+	for(; m < plan->modules + plan->num_modules; m++) {
+		if(m->clock >= 0 && (plan->clock_values[m->clock] & m->clock_off) != 0) {
+			for(; i < m->end; i++)
+				values[plan->order[i]] = 0;
+			continue;
+		}
+
+		for(last = NULL, v = 0; i < m->end; i++) {
+			if(plan->burst[i] > 1) {
+				last = plan->virt[i];
+				for(k = 0, n = plan->burst[i]; k < n; k++)
+					values[plan->order[i + k]] = last[k];
+				i += n - 1;
+				last += n - 1;
+				v = values[plan->order[i]];
+				continue;
+			}
+			if(plan->virt[i] != last) {
+				last = plan->virt[i];
+				v = last != NULL ? *last : 0;
+			}
+			values[plan->order[i]] = v;
+		}
+	}
+}
+
+/*
+ * Drops the module of a faulting register from a plan
+ * Input:
+ *	const struct read_plan *plan	- plan being run
+ *	void *addr			- address of the bus error
+ *
+ * Output:
+ *	slot to resume the run from, the faulting one
+ */
+static int plan_fault(const struct read_plan *plan, void *addr) {
+	int i, j;
+
+	// a module state register, the run starts again without it
+	for(i = 0; i < plan->num_clocks; i++) {
+		if((void *) plan->clocks[i] == addr) {
+			plan->clocks[i] = NULL;
+			return 0;
+		}
+	}
+
+	for(i = 0; i < plan->n && (void *) plan->virt[i] != addr; i++)
+		;
+
+	// not a register of the plan, the fault is fatal as without the guard
+	if(i == plan->n) {
+		signal(SIGBUS, SIG_DFL);
+		raise(SIGBUS);
+	}
+
+	avail_mark(plan->rr, plan->entry[i]);
+	for(j = 0; j < plan->n; j++) {
+		if(plan->rr->absent[plan->entry[j]]) {
+			plan->virt[j] = NULL;
+			plan->burst[j] = 0;
+		}
+	}
+
+	return i;
+}
+
+/* Executes a plan, values[] receives one value per requested register */
+void plan_run(const struct read_plan *plan, uint32_t *values) {
+	sigjmp_buf env, *prev;
+	int start = 0;
+
+	// a bus error comes back here
+	prev = mem_guard(&env);
+	if(sigsetjmp(env, 0) != 0)
+		start = plan_fault(plan, mem_fault_addr());
+	if(start == 0)
+		plan_run_clocks(plan);
+	plan_run_from(plan, values, start);
+	mem_guard(prev);
+}
+
+void plan_free(struct read_plan *plan) {
+	free(plan->order);
+	free((void *) plan->virt);
+	free(plan->entry);
+	free(plan->burst);
+	free(plan->modules);
+	free((void *) plan->clocks);
+	free(plan->clock_values);
+	memset(plan, 0, sizeof(*plan));
+}
@@ -0,0 +1,139 @@
+/*
+ * proto.c : frame I/O helpers, blocking ones for the simple client and
+ * buffer management for the event loops
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+#include "proto.h"
+
+static int write_all(int fd, const void *buf, size_t len) {
+	const uint8_t *p = buf;
+
+	while(len > 0) {
+		ssize_t n = write(fd, p, len);
+
+		if(n < 0) {
+			if(errno == EINTR)
+				continue;
+			return -1;
+		}
+		p += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+static int read_all(int fd, void *buf, size_t len) {
+	uint8_t *p = buf;
+
+	while(len > 0) {
+		ssize_t n = read(fd, p, len);
+
+		if(n < 0) {
+			if(errno == EINTR)
+				continue;
+			return -1;
+		}
+		if(n == 0) {
+			errno = ECONNRESET;
+			return -1;
+		}
+		p += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+/* Sends one frame
+ * Output:
+ *	0 on success, -1 with errno set
+ */
+int dd_send(int fd, int op, int status, const void *payload, uint32_t len) {
+	uint8_t hdr[DD_HDR_SIZE];
+
+	dd_put_hdr(hdr, op, status, len);
+	if(write_all(fd, hdr, sizeof(hdr)) == -1)
+		return -1;
+
+	return write_all(fd, payload, len);
+}
+
+/* Receives one frame, the payload is malloc()ed and has to be freed by the caller
+ * Output:
+ *	0 on success, -1 with errno set
+ */
+int dd_recv(int fd, struct dd_hdr *hdr, uint8_t **payload) {
+	uint8_t buf[DD_HDR_SIZE];
+
+	*payload = NULL;
+	if(read_all(fd, buf, sizeof(buf)) == -1)
+		return -1;
+
+	dd_get_hdr(buf, hdr);
+	if(hdr->magic != DD_MAGIC || hdr->len > DD_MAX_PAYLOAD) {
+		errno = EPROTO;
+		return -1;
+	}
+
+	*payload = malloc(hdr->len ? hdr->len : 1);
+	if(*payload == NULL)
+		return -1;
+
+	if(read_all(fd, *payload, hdr->len) == -1) {
+		free(*payload);
+		*payload = NULL;
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Makes sure a buffer can hold len more bytes
+ * Output:
+ *	0 on success, -1 on allocation failure
+ */
+int dd_reserve(uint8_t **buf, size_t *size, size_t used, size_t len) {
+	size_t want = *size ? *size : 4096;
+	uint8_t *p;
+
+	if(used + len <= *size)
+		return 0;
+
+	while(want < used + len)
+		want *= 2;
+
+	if((p = realloc(*buf, want)) == NULL)
+		return -1;
+
+	*buf = p;
+	*size = want;
+	return 0;
+}
+
+const char *dd_strerror(int status) {
+	switch(status) {
+		case DD_OK:
+			return "ok";
+		case DD_EINVAL:
+			return "malformed request";
+		case DD_ENOENT:
+			return "register not found";
+		case DD_EOP:
+			return "unknown operation";
+		case DD_ENODATA:
+			return "daemon keeps no rollups";
+		case DD_EFAULT:
+			return "module not available";
+		case DD_EACCES:
+			return "register not read, side effects on read";
+		default:
+			return "unknown error";
+	}
+}
@@ -0,0 +1,137 @@
+/*
+ * proto.h : binary protocol spoken between the devicedbg daemon and clients
+ *
+ * Every message is a frame made of a fixed 8 byte header and a payload:
+ *
+ *	magic	u8	DD_MAGIC
+ *	op	u8	one of DD_OP_*, replies carry the op of the request
+ *	status	u16	0 in requests, DD_OK or one of DD_E* in replies
+ *	len	u32	payload length in bytes
+ *
+ * All integers are little endian. Registers are addressed by their physical
+ * address, the daemon only accepts the addresses of its register registry.
+ *
+ *	DD_OP_INFO	request: -
+ *			reply:	 u32 type, u32 count, u32 hash, char family[16]
+ *	DD_OP_READ	request: u32 address
+ *			reply:	 u32 value
+ *			DD_EACCES if the register has side effects on read
+ *			and the daemon runs without -X
+ *	DD_OP_SNAPSHOT	request: -
+ *			reply:	 u32 hash, u32 count, u32 value[count] (registry order)
+ *	DD_OP_DIFF	request: -
+ *			reply:	 u32 n, n * { u32 index, u32 old, u32 new }
+ *			changes since the previous SNAPSHOT or DIFF on the same
+ *			connection; the first one only records the baseline
+ *	DD_OP_READ_BATCH request: u32 n, u32 address[n]
+ *			reply:	 u32 n, u32 value[n] (request order)
+ *			DD_EACCES if one has side effects on read, as for
+ *			DD_OP_READ
+ *	DD_OP_READ_SET	request: char name[len], an instance ("UART1") or a
+ *				 pattern over "INSTANCE.REGISTER" ("UART*.LSR")
+ *			reply:	 u32 n, n * { u32 index, u32 value }
+ *			without the registers with side effects on read,
+ *			unless the daemon runs with -X
+ *	DD_OP_SUBSCRIBE	request: char pattern[len], as for DD_OP_READ_SET
+ *			reply:	 u32 n, registers matching the pattern
+ *			adds the registers to the connection's filter, the
+ *			daemon then pushes DD_OP_EVENT frames when they change
+ *	DD_OP_UNSUBSCRIBE request: -
+ *			reply:	 -
+ *	DD_OP_EVENT	pushed:	 u32 sample, u32 n, n * { u32 index, u32 old, u32 new }
+ *			changes seen by the daemon's sampler at one sample
+ *	DD_OP_DROPPED	pushed:	 u32 n, events lost since the previous notice
+ *			because the subscriber did not keep up; the following
+ *			events do not chain with the ones before
+ *	DD_OP_ROLLUP	request: u32 tier (0: 1 s, 1: 1 min, 2: 1 h), u32 address,
+ *				 u32 max
+ *			reply:	 u32 period (seconds), u32 n, n * { u32 start,
+ *				 u32 samples, u32 last, u32 min, u32 max,
+ *				 u32 changes }, the latest closed windows of
+ *				 the register, oldest first; DD_ENODATA if the
+ *				 daemon keeps no rollups
+ *
+ * A client may send any number of requests without waiting for the replies,
+ * they are executed and answered in order. A batch or a set is read in one
+ * pass over the daemon's mappings, sorted by address. Pushed frames may come
+ * in between replies on a subscribed connection.
+ */
+
+#ifndef _PROTO_H_
+#define _PROTO_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <endian.h>
+
+#define DD_MAGIC		0xDD
+#define DD_HDR_SIZE		8
+#define DD_MAX_PAYLOAD		(1024 * 1024)
+
+/* operations */
+#define DD_OP_INFO		1
+#define DD_OP_READ		2
+#define DD_OP_SNAPSHOT		3
+#define DD_OP_DIFF		4
+#define DD_OP_READ_BATCH	5
+#define DD_OP_READ_SET		6
+#define DD_OP_SUBSCRIBE		7
+#define DD_OP_UNSUBSCRIBE	8
+#define DD_OP_EVENT		9	/* pushed by the daemon */
+#define DD_OP_DROPPED		10	/* pushed by the daemon */
+#define DD_OP_ROLLUP		11
+
+/* reply status */
+#define DD_OK			0
+#define DD_EINVAL		1	/* malformed request */
+#define DD_ENOENT		2	/* address not in the registry */
+#define DD_EOP			3	/* unknown operation */
+#define DD_ENODATA		4	/* no rollups kept */
+#define DD_EFAULT		5	/* module not clocked or not available */
+#define DD_EACCES		6	/* side effects on read, not allowed (-X) */
+
+struct dd_hdr {
+	uint8_t magic;
+	uint8_t op;
+	uint16_t status;
+	uint32_t len;
+};
+
+static inline void dd_put32(uint8_t *p, uint32_t v) {
+	v = htole32(v);
+	memcpy(p, &v, 4);
+}
+
+static inline uint32_t dd_get32(const uint8_t *p) {
+	uint32_t v;
+
+	memcpy(&v, p, 4);
+	return le32toh(v);
+}
+
+static inline void dd_put_hdr(uint8_t *p, int op, int status, uint32_t len) {
+	uint16_t st = htole16(status);
+
+	p[0] = DD_MAGIC;
+	p[1] = op;
+	memcpy(p + 2, &st, 2);
+	dd_put32(p + 4, len);
+}
+
+static inline void dd_get_hdr(const uint8_t *p, struct dd_hdr *hdr) {
+	uint16_t st;
+
+	hdr->magic = p[0];
+	hdr->op = p[1];
+	memcpy(&st, p + 2, 2);
+	hdr->status = le16toh(st);
+	hdr->len = dd_get32(p + 4);
+}
+
+/* proto.c */
+int dd_send(int fd, int op, int status, const void *payload, uint32_t len);
+int dd_recv(int fd, struct dd_hdr *hdr, uint8_t **payload);
+int dd_reserve(uint8_t **buf, size_t *size, size_t used, size_t len);
+const char *dd_strerror(int status);
+
+#endif
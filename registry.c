@@ -0,0 +1,436 @@
+/*
+ * registry.c : flat view of every register of the detected SoC family
+ *
+ * The registry lists all the (instance, register) pairs of a family in table
+ * order and gives each one a qualified "INSTANCE.REGISTER" name, e.g.
+ * "UART1.MDR1" for UART_MDR1 of UART1. The register names of the tables are
+ * front-coded (reg_name()), the qualified name of an entry is decoded when it
+ * is printed (reg_entry_name()). The lookups compare names at every step,
+ * so the registry decodes all of them once, into one pool. Its order is the
+ * layout used by the snapshots, and its hash identifies that layout between
+ * processes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fnmatch.h>
+
+#include "devicedbg.h"
+
+/* FNV-1a, 32-bit */
+uint32_t fnv1a(uint32_t hash, const void *data, size_t len) {
+	const unsigned char *p = data;
+
+	while(len--) {
+		hash ^= *p++;
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+/*
+ * Decodes the name of a register of a table
+ * Input:
+ *	const struct reg_info *regs	- registers of a section
+ *	int r				- register
+ *	char *buf			- receives the name, REG_NAME_LEN bytes
+ *
+ * Output:
+ *	buf
+ */
+const char *reg_name(const struct reg_info *regs, int r, char *buf) {
+	int i;
+
+	// each name is the number of leading characters it shares with the previous
+	// one, then the rest; every REG_NAME_RESTART-th name shares none
+	for(i = r - r % REG_NAME_RESTART; i <= r; i++)
+		strcpy(buf + (unsigned char) regs[i].name[0], regs[i].name + 1);
+
+	return buf;
+}
+
+/*
+ * Decodes the "INSTANCE.REGISTER" name of a registry entry, the instance
+ * prefix ("UART" for "UART1") is dropped from the register name when it is there
+ * Input:
+ *	const struct reg_entry *e	- entry
+ *	char *buf			- receives the name, REG_NAME_LEN bytes
+ *
+ * Output:
+ *	buf
+ */
+const char *reg_entry_name(const struct reg_entry *e, char *buf) {
+	char reg[REG_NAME_LEN];
+	const char *name = reg_name(e->section->regs, e->reg - e->section->regs, reg);
+	size_t prefix = strlen(e->instance->name);
+
+	while(prefix > 0 && isdigit((unsigned char) e->instance->name[prefix - 1]))
+		prefix--;
+
+	if(strncmp(name, e->instance->name, prefix) == 0 && name[prefix] == '_')
+		name += prefix + 1;
+
+	snprintf(buf, REG_NAME_LEN, "%s.%s", e->instance->name, name);
+	return buf;
+}
+
+/* decoded name of a registry entry */
+#define registry_name(rr, i)	((rr)->name_pool + (rr)->name_at[i])
+
+/* Candidate entry of a name in the perfect hash, -1 if no entry has it */
+static int registry_hash_lookup(const struct reg_registry *rr, const char *name) {
+	const struct reg_name_index *ni = rr->names;
+	const char *p;
+	uint32_t h0 = 0, h1 = 0, d, m = ni->num_keys;
+	uint64_t pos;
+	int idx, c;
+
+	// two multiplicative hashes of the lowercase name, as in regtab.awk
+	for(p = name; *p; p++) {
+		c = tolower((unsigned char) *p);
+		h0 = h0 * 31 + c;
+		h1 = h1 * 131 + c;
+	}
+
+	d = ni->displace[h0 % ni->num_buckets];
+	pos = (h1 % m + (uint64_t) (d / m) * (h0 / ni->num_buckets % m) + d % m) % m;
+	idx = ni->slots[pos];
+
+	return strcasecmp(registry_name(rr, idx), name) == 0 ? idx : -1;
+}
+
+static const struct reg_registry *sort_registry;
+
+static int registry_name_cmp(const void *a, const void *b) {
+	int x = *(const int *) a, y = *(const int *) b;
+	int c = strcasecmp(registry_name(sort_registry, x), registry_name(sort_registry, y));
+
+	return c ? c : x - y;
+}
+
+/* Sorted names and perfect hash of the registry, from the generated index
+ * when it describes this registry */
+static void registry_index_names(struct reg_registry *rr, const struct soc_tables *tables) {
+	const struct reg_name_index *ni = tables->names;
+	int i, j;
+
+	if(ni != NULL && ni->count == rr->count) {
+		rr->names = ni;
+		for(i = 0; i < rr->count; i++)
+			rr->by_name[i] = ni->by_name[i];
+
+		// a name given twice resolves to its first entry
+		for(i = 0; i < rr->count && rr->names != NULL; i++) {
+			if((j = registry_hash_lookup(rr, registry_name(rr, i))) < 0 ||
+			   j > i)
+				rr->names = NULL;
+		}
+		for(i = 1; i < rr->count && rr->names != NULL; i++) {
+			if(registry_name_cmp(&rr->by_name[i - 1], &rr->by_name[i]) >= 0)
+				rr->names = NULL;
+		}
+		if(rr->names != NULL)
+			return;
+	}
+
+	for(i = 0; i < rr->count; i++)
+		rr->by_name[i] = i;
+	sort_registry = rr;
+	qsort(rr->by_name, rr->count, sizeof(int), registry_name_cmp);
+}
+
+static int registry_addr_cmp(const void *a, const void *b) {
+	unsigned long x = sort_registry->entries[*(const int *) a].addr;
+	unsigned long y = sort_registry->entries[*(const int *) b].addr;
+
+	if(x != y)
+		return x < y ? -1 : 1;
+	return *(const int *) a - *(const int *) b;
+}
+
+/*
+ * Builds the registry of a family
+ * Input:
+ *	struct reg_registry *rr		- registry to fill
+ *	const struct soc_family *family	- detected family
+ *
+ * Output:
+ *	0 on success, -1 on allocation failure
+ */
+int registry_build(struct reg_registry *rr, const struct soc_family *family) {
+	const struct soc_tables *tables = family_tables(family);
+	char name[REG_NAME_LEN];
+	size_t len, pool_len = 0, pool_max = 0;
+	int s, i, r, n = 0;
+
+	memset(rr, 0, sizeof(*rr));
+	rr->family = family;
+
+	for(s = 0; s < tables->num_sections; s++)
+		rr->count += tables->sections[s].num_instances * tables->sections[s].num_regs;
+
+	rr->entries = calloc(rr->count, sizeof(struct reg_entry));
+	rr->by_addr = calloc(rr->count, sizeof(int));
+	rr->by_name = calloc(rr->count, sizeof(int));
+	rr->name_at = calloc(rr->count, sizeof(uint32_t));
+	rr->absent = calloc(rr->count, 1);
+	if(rr->entries == NULL || rr->by_addr == NULL || rr->by_name == NULL ||
+	   rr->name_at == NULL || rr->absent == NULL) {
+		registry_free(rr);
+		return -1;
+	}
+
+	rr->hash = fnv1a(2166136261U, family->name, strlen(family->name));
+
+	for(s = 0; s < tables->num_sections; s++) {
+		const struct reg_section *section = &tables->sections[s];
+
+		for(i = 0; i < section->num_instances; i++) {
+			for(r = 0; r < section->num_regs; r++) {
+				struct reg_entry *e = &rr->entries[n];
+				uint32_t addr;
+
+				e->section = section;
+				e->instance = &section->instances[i];
+				e->reg = &section->regs[r];
+				e->addr = e->instance->base + e->reg->offset;
+				len = strlen(reg_entry_name(e, name)) + 1;
+
+				addr = e->addr;
+				rr->hash = fnv1a(rr->hash, &addr, sizeof(addr));
+				rr->hash = fnv1a(rr->hash, name, len);
+
+				if(pool_len + len > pool_max) {
+					char *pool;
+
+					pool_max = pool_max ? 2 * pool_max : 16 * REG_NAME_LEN;
+					if((pool = realloc(rr->name_pool, pool_max)) == NULL) {
+						registry_free(rr);
+						return -1;
+					}
+					rr->name_pool = pool;
+				}
+				memcpy(rr->name_pool + pool_len, name, len);
+				rr->name_at[n] = pool_len;
+				pool_len += len;
+
+				rr->by_addr[n] = n;
+				n++;
+			}
+		}
+	}
+
+	sort_registry = rr;
+	qsort(rr->by_addr, rr->count, sizeof(int), registry_addr_cmp);
+	registry_index_names(rr, tables);
+
+	return 0;
+}
+
+void registry_free(struct reg_registry *rr) {
+	free(rr->entries);
+	free(rr->by_addr);
+	free(rr->by_name);
+	free(rr->name_pool);
+	free(rr->name_at);
+	free(rr->absent);
+	rr->entries = NULL;
+	rr->by_addr = NULL;
+	rr->by_name = NULL;
+	rr->name_pool = NULL;
+	rr->name_at = NULL;
+	rr->absent = NULL;
+	rr->names = NULL;
+	rr->count = 0;
+}
+
+/* Finds a register by physical address
+ * Output:
+ *	registry index or -1
+ */
+int registry_find_addr(const struct reg_registry *rr, unsigned long addr) {
+	int lo = 0, hi = rr->count;
+
+	while(lo < hi) {
+		int mid = (lo + hi) / 2;
+
+		if(rr->entries[rr->by_addr[mid]].addr < addr)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if(lo < rr->count && rr->entries[rr->by_addr[lo]].addr == addr)
+		return rr->by_addr[lo];
+	return -1;
+}
+
+/* Range of by_name[] whose names start with a prefix (case insensitive), a
+ * length of strlen(prefix) + 1 gives the names equal to it
+ * Output:
+ *	first position, *end receives the end of the range
+ */
+static int registry_prefix_range(const struct reg_registry *rr, const char *prefix, size_t len,
+				 int *end) {
+	int lo = 0, hi = rr->count, mid, first;
+
+	while(lo < hi) {
+		mid = (lo + hi) / 2;
+		if(strncasecmp(registry_name(rr, rr->by_name[mid]), prefix, len) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	first = lo;
+
+	for(hi = rr->count; lo < hi; ) {
+		mid = (lo + hi) / 2;
+		if(strncasecmp(registry_name(rr, rr->by_name[mid]), prefix, len) <= 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	*end = lo;
+	return first;
+}
+
+static int registry_int_cmp(const void *a, const void *b) {
+	return *(const int *) a - *(const int *) b;
+}
+
+/* Finds a register by its "INSTANCE.REGISTER" name (case insensitive)
+ * Output:
+ *	registry index or -1
+ */
+int registry_find_name(const struct reg_registry *rr, const char *name) {
+	int lo, hi;
+
+	if(rr->names != NULL)
+		return registry_hash_lookup(rr, name);
+
+	lo = registry_prefix_range(rr, name, strlen(name) + 1, &hi);
+	return lo < hi ? rr->by_name[lo] : -1;
+}
+
+/* Finds a register given either its name or its physical address
+ * Output:
+ *	registry index or -1
+ */
+int registry_lookup(const struct reg_registry *rr, const char *arg) {
+	unsigned long addr;
+	char *end;
+
+	errno = 0;
+	addr = strtoul(arg, &end, 0);
+	if(errno == 0 && end != arg && *end == '\0')
+		return registry_find_addr(rr, addr);
+
+	return registry_find_name(rr, arg);
+}
+
+/*
+ * Resolves a named register set: either an instance name ("UART1") or a
+ * shell pattern over the qualified names ("UART*.LSR", "GPT?.TCRR")
+ * Input:
+ *	const char *pattern	- set name
+ *	int *indices		- receives up to rr->count registry indices
+ *
+ * Output:
+ *	number of registers in the set
+ */
+int registry_match(const struct reg_registry *rr, const char *pattern, int *indices) {
+	char prefix[REG_NAME_LEN + 1];
+	int i, end, n = 0;
+	size_t len;
+
+	// the registers of an instance are the names starting with "INSTANCE."
+	if((len = strlen(pattern)) < REG_NAME_LEN) {
+		snprintf(prefix, sizeof(prefix), "%s.", pattern);
+		for(i = registry_prefix_range(rr, prefix, len + 1, &end); i < end; i++) {
+			if(strcasecmp(rr->entries[rr->by_name[i]].instance->name, pattern) == 0)
+				indices[n++] = rr->by_name[i];
+		}
+	}
+
+	// otherwise only the names sharing the literal prefix of the pattern can match
+	if(n == 0) {
+		len = strcspn(pattern, "*?[\\");
+		for(i = registry_prefix_range(rr, pattern, len, &end); i < end; i++) {
+			if(fnmatch(pattern, registry_name(rr, rr->by_name[i]), FNM_CASEFOLD) == 0)
+				indices[n++] = rr->by_name[i];
+		}
+	}
+
+	qsort(indices, n, sizeof(int), registry_int_cmp);
+	return n;
+}
+
+/* Registry indices of the registers the plans read (plan_readable()), in
+ * registry order
+ * Output:
+ *	number of registers, indices receives up to rr->count of them
+ */
+int registry_readable(const struct reg_registry *rr, int *indices) {
+	int i, n = 0;
+
+	for(i = 0; i < rr->count; i++) {
+		if(plan_readable(rr->entries[i].reg))
+			indices[n++] = i;
+	}
+
+	return n;
+}
+
+/* Registry indices matched by any of the patterns, all of them without any,
+ * in registry order, leaving out the registers the plans do not read
+ * Output:
+ *	number of registers
+ */
+int registry_select(const struct reg_registry *rr, int argc, char **argv, int *indices) {
+	uint8_t *selected;
+	int i, j, n = 0, skipped = 0;
+
+	if((selected = calloc(rr->count, 1)) == NULL) FATAL;
+
+	if(argc == 0)
+		memset(selected, 1, rr->count);
+
+	for(i = 0; i < argc; i++) {
+		n = registry_match(rr, argv[i], indices);
+		if(n == 0)
+			fprintf(stderr, "devicedbg: no register matches %s\n", argv[i]);
+		for(j = 0; j < n; j++)
+			selected[indices[j]] = 1;
+	}
+
+	for(i = n = 0; i < rr->count; i++) {
+		if(selected[i] && !plan_readable(rr->entries[i].reg))
+			skipped++;
+		else if(selected[i])
+			indices[n++] = i;
+	}
+
+	if(skipped)
+		fprintf(stderr, "devicedbg: %d registers with side effects on read left out\n", skipped);
+
+	free(selected);
+	return n;
+}
+
+/* Reads all the registers of the registry, in registry order, 0 for absent modules
+ * and the registers the plans do not read */
+void registry_read(const struct reg_registry *rr, uint32_t *values) {
+	int i;
+
+	for(i = 0; i < rr->count; i++) {
+		values[i] = 0;
+		if(!rr->absent[i] && plan_readable(rr->entries[i].reg) &&
+		   mem_try_read32(rr->entries[i].addr, &values[i]) == -1)
+			avail_mark(rr, i);
+	}
+}
@@ -0,0 +1,534 @@
+#
+# regtab.awk : generates the register tables of a family from its description
+#
+# Usage: awk -v family=am335x -f regtab.awk am335x.desc
+#
+# The description is the text format of desc.c. Two files are written:
+#
+#	<family>_regs.h	offsets, window and base addresses, field shifts,
+#			masks and values, and the typed accessors of every
+#			register and field (a struct type per section)
+#	<family>_regs.c	the struct soc_tables of the family, built on the
+#			offsets of the header, and the build time checks
+#
+# The checks are compiled, not run: every offset is 32 bit aligned and its
+# register fits in the window of its section (4 KiB unless the section record
+# gives one), no two registers of a section share an offset (duplicate case
+# values) and the fields of a register do not overlap.
+#
+# The attribute of a register record (clear, fifo, write) becomes its access
+# in the table; write-only registers get no read accessors.
+#
+# Identical field and value lists are emitted once per family.
+#
+# The name index of the registry is computed here too (struct reg_name_index,
+# see registry.c): the "INSTANCE.REGISTER" names in registry order, sorted,
+# and a minimal perfect hash of them. Run it with LC_ALL=C, names are
+# compared as bytes.
+#
+
+BEGIN {
+	FS = ","
+	if (family == "") {
+		print "regtab.awk: family not set" > "/dev/stderr"
+		exit 1
+	}
+	FAM = toupper(family)
+	hfile = family "_regs.h"
+	cfile = family "_regs.c"
+	nsec = nreg = ninst = nfield = nenum = nmask = 0
+	REG_NAME_LEN = 48		# as in devicedbg.h, checked by the tables
+	REG_NAME_RESTART = 8
+	reg_attr["clear"] = "REG_READ_CLEARS"
+	reg_attr["fifo"] = "REG_FIFO"
+	reg_attr["write"] = "REG_WRITE_ONLY"
+	for (i = 1; i < 256; i++)
+		ord[sprintf("%c", i)] = i
+}
+
+function fail(why) {
+	printf("%s:%d: %s\n", FILENAME, FNR, why) > "/dev/stderr"
+	failed = 1
+	exit 1
+}
+
+# C identifier from a register, field or section name
+function ident(s) {
+	s = toupper(s)
+	gsub(/[^A-Z0-9]+/, "_", s)
+	sub(/^_+/, "", s)
+	sub(/_+$/, "", s)
+	return s
+}
+
+# unique identifier in a namespace, suffixed with the offset on collision
+function unique(space, s, alt) {
+	if ((space, s) in used) {
+		s = s "_" alt
+		if ((space, s) in used)
+			fail("identifier " s " defined twice")
+	}
+	used[space, s] = 1
+	return s
+}
+
+{
+	sub(/\r$/, "")
+	sub(/[ \t]+$/, "")
+}
+
+/^#/ || /^[ \t]*$/ {
+	next
+}
+
+$1 == "family" && NF == 2 {
+	name = $2
+	next
+}
+
+$1 == "section" && (NF == 2 || NF == 3) {
+	nsec++
+	sec_name[nsec] = $2
+	sec_id[nsec] = $2
+	sub(/\/.*/, "", sec_id[nsec])
+	sec_ident[nsec] = ident($2)
+	sec_var[nsec] = family "_" tolower(sec_ident[nsec])
+	sec_window[nsec] = NF == 3 ? $3 : "0x1000"
+	sec_reg[nsec] = nreg + 1
+	sec_inst[nsec] = ninst + 1
+	next
+}
+
+$1 == "instance" && NF == 3 {
+	if (nsec == 0)
+		fail("instance outside a section")
+	ninst++
+	inst_name[ninst] = $2
+	inst_base[ninst] = $3
+	next
+}
+
+$1 == "clock" && NF == 3 {
+	if (ninst == 0 || ninst < sec_inst[nsec])
+		fail("clock outside an instance")
+	inst_clock[ninst] = $2
+	inst_clock_off[ninst] = $3
+	next
+}
+
+$1 == "register" && (NF == 3 || NF == 4) {
+	if (nsec == 0)
+		fail("register outside a section")
+	if (NF == 4 && !($4 in reg_attr))
+		fail("unknown register attribute " $4)
+	nreg++
+	reg_off[nreg] = $2
+	reg_name[nreg] = $3
+	reg_access[nreg] = NF == 4 ? reg_attr[$4] : "REG_READ_SAFE"
+	if (length($3) >= REG_NAME_LEN)
+		fail("register name " $3 " longer than REG_NAME_LEN")
+	reg_sec[nreg] = nsec
+	reg_field[nreg] = nfield + 1
+	reg_ident[nreg] = unique("reg", FAM "_" ident($3), toupper(substr($2, 3)))
+	next
+}
+
+$1 == "field" && NF == 4 {
+	if (nreg == 0 || reg_sec[nreg] != nsec)
+		fail("field outside a register")
+	nfield++
+	field_name[nfield] = $2
+	field_shift[nfield] = $3 + 0
+	field_width[nfield] = $4 + 0
+	field_reg[nfield] = nreg
+	field_enum[nfield] = nenum + 1
+	field_ident[nfield] = unique("field", reg_ident[nreg] "_" ident($2), field_shift[nfield])
+	if (field_width[nfield] < 1 || field_shift[nfield] + field_width[nfield] > 32)
+		fail("field " $2 " outside 32 bits")
+	next
+}
+
+$1 == "enum" && NF == 3 {
+	if (nfield == 0 || field_reg[nfield] != nreg)
+		fail("enum outside a field")
+	nenum++
+	enum_value[nenum] = $2
+	enum_name[nenum] = $3
+	enum_field[nenum] = nfield
+	next
+}
+
+$1 == "mask" && NF == 3 {
+	nmask++
+	mask_pattern[nmask] = $2
+	mask_ignore[nmask] = $3
+	next
+}
+
+{
+	fail("unknown record")
+}
+
+# mask of a field as a C expression
+function field_mask(f) {
+	if (field_width[f] == 32)
+		return "0xFFFFFFFFU"
+	return sprintf("(0x%XU << %d)", 2 ^ field_width[f] - 1, field_shift[f])
+}
+
+function emit_header(   s, r, f, e, i, lower, block, flower) {
+	print "/*" > hfile
+	print " * " hfile " : typed register access of the " name " family" > hfile
+	print " *" > hfile
+	print " * Generated from " FILENAME " by regtab.awk, do not edit." > hfile
+	print " *" > hfile
+	print " * Every section is an incomplete struct type, the block of its registers:" > hfile
+	print " * <section>_at() types the mapped base of an instance, and the accessors of a" > hfile
+	print " * register only accept a block of its own section. All the registers are" > hfile
+	print " * 32 bit wide; the offsets and masks are constants, so a read is one load" > hfile
+	print " * and a field read one load and a shift and mask." > hfile
+	print " *" > hfile
+	print " *	<REG>				offset of a register in its block" > hfile
+	print " *	<REG>_<FIELD>_SHIFT, _MASK	position of a field" > hfile
+	print " *	<REG>_<FIELD>_<VALUE>		named values of a field" > hfile
+	print " *	<reg>_read(), <reg>_write()	access to a register" > hfile
+	print " *	<reg>_<field>_get(), _set()	field of a register value" > hfile
+	print " *	<reg>_<field>_read()		field of a register" > hfile
+	print " *" > hfile
+	print " * Write-only registers have no _read() accessors." > hfile
+	print " *" > hfile
+	print " * The register tables in " cfile " are the runtime view of the same" > hfile
+	print " * definitions." > hfile
+	print " */" > hfile
+	print "" > hfile
+	print "#ifndef _" FAM "_REGS_H_" > hfile
+	print "#define _" FAM "_REGS_H_" > hfile
+	print "" > hfile
+	print "#include <stdint.h>" > hfile
+
+	for (s = 1; s <= nsec; s++) {
+		block = sec_var[s]
+		print "" > hfile
+		print "/* " sec_name[s] " */" > hfile
+		print "struct " block ";" > hfile
+		print "" > hfile
+		printf("#define %s_%s_WINDOW\t%s\n", FAM, sec_ident[s], sec_window[s]) > hfile
+		for (i = sec_inst[s]; i <= ninst && (s == nsec || i < sec_inst[s + 1]); i++)
+			printf("#define %s_BASE\t%sUL\n", unique("base", FAM "_" ident(inst_name[i]), i),
+			       inst_base[i]) > hfile
+		print "" > hfile
+		print "static inline volatile struct " block " *" block "_at(volatile void *base) {" > hfile
+		print "\treturn (volatile struct " block " *) base;" > hfile
+		print "}" > hfile
+
+		for (r = sec_reg[s]; r <= nreg && reg_sec[r] == s; r++) {
+			lower = tolower(reg_ident[r])
+			print "" > hfile
+			printf("#define %s\t%s\t/* %s */\n", reg_ident[r], reg_off[r], reg_name[r]) > hfile
+			for (f = reg_field[r]; f <= nfield && field_reg[f] == r; f++) {
+				printf("#define %s_SHIFT\t%d\n", field_ident[f], field_shift[f]) > hfile
+				printf("#define %s_MASK\t%s\n", field_ident[f], field_mask(f)) > hfile
+				for (e = field_enum[f]; e <= nenum && enum_field[e] == f; e++)
+					printf("#define %s\t%s\n", unique("enum", field_ident[f] "_" ident(enum_name[e]), e),
+					       enum_value[e]) > hfile
+			}
+
+			if (reg_access[r] != "REG_WRITE_ONLY") {
+				print "" > hfile
+				if (reg_access[r] != "REG_READ_SAFE")
+					print "/* " reg_access[r] ": reading " reg_name[r] " has side effects */" > hfile
+				print "static inline uint32_t " lower "_read(const volatile struct " block " *block) {" > hfile
+				print "\treturn *(const volatile uint32_t *) ((const volatile char *) block + " reg_ident[r] ");" > hfile
+				print "}" > hfile
+			}
+			print "" > hfile
+			print "static inline void " lower "_write(volatile struct " block " *block, uint32_t value) {" > hfile
+			print "\t*(volatile uint32_t *) ((volatile char *) block + " reg_ident[r] ") = value;" > hfile
+			print "}" > hfile
+
+			for (f = reg_field[r]; f <= nfield && field_reg[f] == r; f++) {
+				flower = tolower(field_ident[f])
+				print "" > hfile
+				print "static inline uint32_t " flower "_get(uint32_t value) {" > hfile
+				print "\treturn (value & " field_ident[f] "_MASK) >> " field_ident[f] "_SHIFT;" > hfile
+				print "}" > hfile
+				print "" > hfile
+				print "static inline uint32_t " flower "_set(uint32_t value, uint32_t field) {" > hfile
+				print "\treturn (value & ~" field_ident[f] "_MASK) | ((field << " field_ident[f] "_SHIFT) & " field_ident[f] "_MASK);" > hfile
+				print "}" > hfile
+				if (reg_access[r] == "REG_WRITE_ONLY")
+					continue
+				print "" > hfile
+				print "static inline uint32_t " flower "_read(const volatile struct " block " *block) {" > hfile
+				print "\treturn " flower "_get(" lower "_read(block));" > hfile
+				print "}" > hfile
+			}
+		}
+	}
+
+	print "" > hfile
+	print "#endif /* _" FAM "_REGS_H_ */" > hfile
+}
+
+# name of the table of the fields of a register, NULL if it has none
+function emit_fields(r,   f, e, key, ekey, evar, text) {
+	if (reg_field[r] > nfield || field_reg[reg_field[r]] != r)
+		return "NULL"
+
+	key = ""
+	for (f = reg_field[r]; f <= nfield && field_reg[f] == r; f++) {
+		ekey = ""
+		for (e = field_enum[f]; e <= nenum && enum_field[e] == f; e++)
+			ekey = ekey "\t{ " enum_value[e] ", \"" enum_name[e] "\" },\n"
+
+		evar = "NULL"
+		if (ekey != "") {
+			if (!(ekey in enum_var)) {
+				enum_var[ekey] = family "_values_" ++nenum_var
+				printf("static const struct reg_enum %s[] SOC_TABLE(%s) = {\n%s\t{ 0, NULL }\n};\n\n",
+				       enum_var[ekey], family, ekey) > cfile
+			}
+			evar = enum_var[ekey]
+		}
+		key = key sprintf("\t{ \"%s\", %d, %d, %s },\n", field_name[f], field_shift[f],
+				  field_width[f], evar)
+	}
+
+	if (!(key in field_var)) {
+		field_var[key] = family "_fields_" ++nfield_var
+		printf("static const struct reg_field %s[] SOC_TABLE(%s) = {\n%s\t{ NULL }\n};\n\n",
+		       field_var[key], family, key) > cfile
+	}
+	return field_var[key]
+}
+
+# name of a register front-coded against the previous one of its section, as
+# decoded by reg_name(): the length of the shared prefix then the rest
+function front_code(s, r,   prev, n) {
+	if ((r - sec_reg[s]) % REG_NAME_RESTART != 0) {
+		prev = reg_name[r - 1]
+		while (n < length(prev) && substr(prev, n + 1, 1) == substr(reg_name[r], n + 1, 1))
+			n++
+	}
+	return sprintf("\\%03o", n) substr(reg_name[r], n + 1)
+}
+
+function emit_tables(   s, r, f, i, fields, sep, or, sum) {
+	print "/*" > cfile
+	print " * " cfile " : register tables of the " name " family" > cfile
+	print " *" > cfile
+	print " * Generated from " FILENAME " by regtab.awk, do not edit." > cfile
+	print " *" > cfile
+	print " * All the tables below are const and live in the family's own read-only" > cfile
+	print " * section (see SOC_TABLE() in devicedbg.h). The section starts on a page" > cfile
+	print " * boundary, so the tables of the families which are not detected at runtime" > cfile
+	print " * are never paged in." > cfile
+	print " */" > cfile
+	print "" > cfile
+	print "#include \"devicedbg.h\"" > cfile
+	print "#include \"" hfile "\"" > cfile
+	print "" > cfile
+
+	for (r = 1; r <= nreg; r++)
+		reg_fields[r] = emit_fields(r)
+
+	for (s = 1; s <= nsec; s++) {
+		printf("static const struct reg_info %s_registers[] SOC_TABLE(%s) = {\n", sec_var[s], family) > cfile
+		for (r = sec_reg[s]; r <= nreg && reg_sec[r] == s; r++)
+			printf("\t{ %s, \"%s\", %s, %s },\n", reg_ident[r], front_code(s, r), reg_fields[r],
+			       reg_access[r]) > cfile
+		print "};\n" > cfile
+
+		printf("static const struct reg_instance %s_instances[] SOC_TABLE(%s) = {\n", sec_var[s], family) > cfile
+		for (i = sec_inst[s]; i <= ninst && (s == nsec || i < sec_inst[s + 1]); i++)
+			if (i in inst_clock)
+				printf("\t{ \"%s\", %s, %sUL, %s },\n", inst_name[i], inst_base[i],
+				       inst_clock[i], inst_clock_off[i]) > cfile
+			else
+				printf("\t{ \"%s\", %s },\n", inst_name[i], inst_base[i]) > cfile
+		print "};\n" > cfile
+	}
+
+	printf("static const struct reg_section %s_sections[] SOC_TABLE(%s) = {\n", family, family) > cfile
+	for (s = 1; s <= nsec; s++)
+		printf("\tSOC_SECTION(%s, %s_registers, %s_instances),\n", sec_id[s], sec_var[s], sec_var[s]) > cfile
+	print "};\n" > cfile
+
+	printf("static const struct reg_mask %s_masks[] SOC_TABLE(%s) = {\n", family, family) > cfile
+	for (i = 1; i <= nmask; i++)
+		printf("\t{ \"%s\", %s },\n", mask_pattern[i], mask_ignore[i]) > cfile
+	print "};\n" > cfile
+
+	emit_names()
+
+	printf("const struct soc_tables %s_tables SOC_TABLE_ANCHOR(%s) = {\n", family, family) > cfile
+	printf("\t%s_sections, ARRAY_SIZE(struct reg_section, %s_sections),\n", family, family) > cfile
+	printf("\t%s_masks, ARRAY_SIZE(struct reg_mask, %s_masks),\n", family, family) > cfile
+	printf("\t&%s_names\n", family) > cfile
+	print "};\n" > cfile
+
+	print "/* the names above are front-coded and checked with these limits */" > cfile
+	printf("_Static_assert(REG_NAME_LEN == %d && REG_NAME_RESTART == %d, \"regtab.awk limits\");\n\n",
+	       REG_NAME_LEN, REG_NAME_RESTART) > cfile
+
+	print "/* offsets are 32 bit aligned and their register fits in the window of the section */" > cfile
+	for (r = 1; r <= nreg; r++)
+		printf("_Static_assert((%s & 3) == 0 && %s + 4 <= %s_%s_WINDOW, \"%s: offset unaligned or outside %s\");\n",
+		       reg_ident[r], reg_ident[r], FAM, sec_ident[reg_sec[r]], reg_name[r], sec_name[reg_sec[r]]) > cfile
+
+	print "\n/* the module state registers are 32 bit aligned and their idle bits set */" > cfile
+	for (i = 1; i <= ninst; i++)
+		if (i in inst_clock)
+			printf("_Static_assert((%sUL & 3) == 0 && %s != 0, \"%s: bad clock record\");\n",
+			       inst_clock[i], inst_clock_off[i], inst_name[i]) > cfile
+
+	print "\n/* the fields of a register do not overlap: the sum of their masks is their OR */" > cfile
+	for (r = 1; r <= nreg; r++) {
+		if (reg_fields[r] == "NULL")
+			continue
+		or = sum = ""
+		for (f = reg_field[r]; f <= nfield && field_reg[f] == r; f++) {
+			sep = or == "" ? "" : " + "
+			sum = sum sep "(uint64_t) " field_ident[f] "_MASK"
+			or = or (or == "" ? "" : " | ") field_ident[f] "_MASK"
+		}
+		printf("_Static_assert(%s == (%s), \"%s: overlapping fields\");\n", sum, or, reg_name[r]) > cfile
+	}
+
+	print "\n/* no two registers of a section share an offset: duplicate case values do not compile */" > cfile
+	printf("static void __attribute__((unused)) %s_unique_offsets(unsigned long offset) {\n", family) > cfile
+	for (s = 1; s <= nsec; s++) {
+		printf("\tswitch(offset) {\t/* %s */\n", sec_name[s]) > cfile
+		for (r = sec_reg[s]; r <= nreg && reg_sec[r] == s; r++)
+			printf("\t\tcase %s:\n", reg_ident[r]) > cfile
+		print "\t\t\tbreak;\n\t}" > cfile
+	}
+	print "}" > cfile
+}
+
+# hash of a lowercase name modulo 2^32, as registry_hash_lookup(); the
+# products stay below 2^53, exact in awk numbers
+function name_hash(s, mul,   h, i, n) {
+	h = 0
+	n = length(s)
+	for (i = 1; i <= n; i++)
+		h = (h * mul + ord[substr(s, i, 1)]) % 4294967296
+	return h
+}
+
+# "INSTANCE.REGISTER" name of a register, as reg_entry_name()
+function registry_name(inst, reg,   prefix) {
+	prefix = inst
+	sub(/[0-9]+$/, "", prefix)
+	if (substr(reg, 1, length(prefix) + 1) == prefix "_")
+		reg = substr(reg, length(prefix) + 2)
+	return inst "." reg
+}
+
+# key before another one: lowercase name, then registry index
+function key_before(i, j) {
+	return key[i] < key[j] || (key[i] == key[j] && i < j)
+}
+
+function emit_list(type, var, list, n,   i, line) {
+	printf("static const %s %s_%s[] SOC_TABLE(%s) = {", type, family, var, family) > cfile
+	for (i = 0; i < n; i++) {
+		if (i % 12 == 0)
+			printf("\n\t") > cfile
+		printf("%s%s", list[i], i % 12 == 11 || i == n - 1 ? "," : ", ") > cfile
+	}
+	print "\n};\n" > cfile
+}
+
+# sorted index and perfect hash of the registry names
+function emit_names(   s, i, r, n, m, nb, k, j, gap, t, b, h0, size, maxsize, a, d, p, ok, stamp, done) {
+	n = 0
+	for (s = 1; s <= nsec; s++)
+		for (i = sec_inst[s]; i <= ninst && (s == nsec || i < sec_inst[s + 1]); i++)
+			for (r = sec_reg[s]; r <= nreg && reg_sec[r] == s; r++) {
+				key[n] = tolower(registry_name(inst_name[i], reg_name[r]))
+				if (length(key[n]) >= REG_NAME_LEN)
+					fail("registry name " key[n] " longer than REG_NAME_LEN")
+				sorted[n] = n
+				n++
+			}
+	if (n > 65535)
+		fail("more than 65535 registers")
+
+	# shell sort of the registry indices by name
+	for (gap = int(n / 2); gap > 0; gap = int(gap / 2))
+		for (i = gap; i < n; i++) {
+			t = sorted[i]
+			for (j = i; j >= gap && key_before(t, sorted[j - gap]); j -= gap)
+				sorted[j] = sorted[j - gap]
+			sorted[j] = t
+		}
+
+	# a name given twice (reserved registers) is hashed once, for its first index
+	m = 0
+	for (i = 0; i < n; i++)
+		if (i == 0 || key[sorted[i]] != key[sorted[i - 1]])
+			hkey[m++] = sorted[i]
+
+	# hash and displace: the keys of a bucket move together by a, b until
+	# they all land on free slots, the largest buckets first
+	nb = int(m / 3) + 1
+	for (b = 0; b < nb; b++) {
+		bsize[b] = 0
+		displace[b] = 0
+	}
+	maxsize = 0
+	for (i = 0; i < m; i++) {
+		k = hkey[i]
+		h0 = name_hash(key[k], 31)
+		b = h0 % nb
+		f1[k] = name_hash(key[k], 131) % m
+		f2[k] = int(h0 / nb) % m
+		bkey[b, bsize[b]++] = k
+		if (bsize[b] > maxsize)
+			maxsize = bsize[b]
+	}
+
+	for (i = 0; i < m; i++)
+		slot[i] = -1
+	stamp = 0
+	for (size = maxsize; size > 0; size--)
+		for (b = 0; b < nb; b++) {
+			if (bsize[b] != size)
+				continue
+			for (d = done = 0; !done; d++) {
+				a = int(d / m)
+				stamp++
+				ok = 1
+				for (j = 0; j < size && ok; j++) {
+					p = (f1[bkey[b, j]] + a * f2[bkey[b, j]] + d % m) % m
+					if (slot[p] != -1 || mark[p] == stamp)
+						ok = 0
+					mark[p] = stamp
+				}
+				if (!ok)
+					continue
+				for (j = 0; j < size; j++)
+					slot[(f1[bkey[b, j]] + a * f2[bkey[b, j]] + d % m) % m] = bkey[b, j]
+				displace[b] = d
+				done = 1
+			}
+		}
+
+	emit_list("uint16_t", "by_name", sorted, n)
+	emit_list("uint32_t", "displace", displace, nb)
+	emit_list("uint16_t", "slots", slot, m)
+
+	printf("static const struct reg_name_index %s_names SOC_TABLE(%s) = {\n", family, family) > cfile
+	printf("\t%d, %d, %d, %s_displace, %s_slots, %s_by_name\n", n, m, nb, family, family, family) > cfile
+	print "};\n" > cfile
+}
+
+END {
+	if (failed)
+		exit 1
+	if (name == "")
+		fail("no family")
+	emit_header()
+	emit_tables()
+}
@@ -0,0 +1,435 @@
+/*
+ * remote.c : one client command run on many daemons at once
+ *
+ * Meant for a workstation reading a bench of boards, each one running the
+ * daemon on a TCP endpoint. All the agents are driven from a single poll()
+ * loop over non-blocking sockets: the connections are opened together, the
+ * registry of each agent is built from its DD_OP_INFO reply, then the command
+ * requests are pipelined. A slow or dead board only holds its own output.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include "devicedbg.h"
+#include "proto.h"
+
+#define RM_MAX_AGENTS	1024
+#define RM_WINDOW	16			/* bench batches in flight per agent */
+#define RM_TIMEOUT	(5 * 1000000000ULL)	/* without any reply */
+
+enum { CMD_READ, CMD_SNAPSHOT, CMD_BENCH };
+enum { AG_CONNECTING, AG_RUNNING, AG_DONE, AG_FAILED };
+
+struct agent {
+	const char *endpoint;
+	int fd, state;
+	struct reg_registry rr;
+	uint8_t *in;
+	size_t in_len, in_size;
+	uint8_t *out;
+	size_t out_off, out_len, out_size;
+	uint8_t *req;			/* READ_BATCH request of the command */
+	uint32_t req_len;
+	int *idx, n;			/* registers of the batch */
+	long sent, done;
+	uint64_t sent_ns[RM_WINDOW];	/* send time of the batches in flight */
+	uint64_t start, stop, last;
+	uint32_t *lat;			/* batch latencies in ns */
+	size_t lat_size;
+};
+
+static struct agent agents[RM_MAX_AGENTS];
+static int num_agents;
+
+static int cmd, cmd_argc, bench_batch;
+static char **cmd_argv;
+static double bench_seconds;
+
+static void agent_fail(struct agent *a, const char *why) {
+	fprintf(stderr, "devicedbg: %s: %s\n", a->endpoint, why);
+	a->state = AG_FAILED;
+}
+
+static int agent_send(struct agent *a, int op, const void *payload, uint32_t len) {
+	if(dd_reserve(&a->out, &a->out_size, a->out_len, DD_HDR_SIZE + len) == -1)
+		return -1;
+
+	dd_put_hdr(a->out + a->out_len, op, 0, len);
+	memcpy(a->out + a->out_len + DD_HDR_SIZE, payload, len);
+	a->out_len += DD_HDR_SIZE + len;
+	return 0;
+}
+
+static int agent_send_batch(struct agent *a) {
+	a->sent_ns[a->sent % RM_WINDOW] = now_ns();
+	a->sent++;
+	return agent_send(a, DD_OP_READ_BATCH, a->req, a->req_len);
+}
+
+/* Prepares and queues the command once the registry of the agent is known */
+static int agent_start(struct agent *a) {
+	int i, *readable = NULL, num_readable = 0;
+
+	a->n = cmd == CMD_READ ? cmd_argc : bench_batch;
+	if(a->n > a->rr.count)
+		a->n = a->rr.count;
+
+	a->req_len = 4 + 4 * a->n;
+	a->req = malloc(a->req_len);
+	a->idx = malloc((a->n ? a->n : 1) * sizeof(int));
+	if(a->req == NULL || a->idx == NULL) FATAL;
+
+	// the bench batches cycle through the registers read without side
+	// effects, the agent refuses a batch holding any other (DD_EACCES)
+	if(cmd != CMD_READ) {
+		if((readable = malloc(a->rr.count * sizeof(int))) == NULL) FATAL;
+		if((num_readable = registry_readable(&a->rr, readable)) == 0) {
+			fprintf(stderr, "devicedbg: %s: no register to read without side effects\n",
+				a->endpoint);
+			free(readable);
+			a->state = AG_FAILED;
+			return 0;
+		}
+	}
+
+	dd_put32(a->req, a->n);
+	for(i = 0; i < a->n; i++) {
+		a->idx[i] = cmd == CMD_READ ? registry_lookup(&a->rr, cmd_argv[i]) :
+			    readable[i % num_readable];
+		if(a->idx[i] < 0) {
+			fprintf(stderr, "devicedbg: %s: unknown register %s\n", a->endpoint, cmd_argv[i]);
+			a->state = AG_FAILED;
+			return 0;
+		}
+		dd_put32(a->req + 4 + 4 * i, a->rr.entries[a->idx[i]].addr);
+	}
+	free(readable);
+
+	a->start = now_ns();
+	a->stop = a->start + bench_seconds * 1e9;
+
+	if(cmd == CMD_SNAPSHOT)
+		return agent_send(a, DD_OP_SNAPSHOT, NULL, 0);
+
+	do {
+		if(agent_send_batch(a) == -1)
+			return -1;
+	} while(cmd == CMD_BENCH && a->sent < RM_WINDOW);
+
+	return 0;
+}
+
+static void agent_print(struct agent *a, const uint8_t *values, int n, const int *idx) {
+	char qname[REG_NAME_LEN];
+	int i;
+
+	for(i = 0; i < n; i++) {
+		const struct reg_entry *e = &a->rr.entries[idx ? idx[i] : i];
+
+		printf("%s %-32s 0x%08lX: 0x%08X\n", a->endpoint, reg_entry_name(e, qname), e->addr,
+		       dd_get32(values + 4 * i));
+	}
+	fflush(stdout);
+}
+
+/* Handles one reply frame
+ * Output:
+ *	0 on success, -1 on allocation failure
+ */
+static int agent_reply(struct agent *a, const struct dd_hdr *hdr, const uint8_t *payload) {
+	uint64_t now = now_ns();
+
+	a->last = now;
+
+	if(hdr->status != DD_OK) {
+		agent_fail(a, dd_strerror(hdr->status));
+		return 0;
+	}
+
+	switch(hdr->op) {
+		case DD_OP_INFO:
+			if(client_info_registry(payload, hdr->len, &a->rr) == -1) {
+				a->state = AG_FAILED;
+				return 0;
+			}
+			return agent_start(a);
+
+		case DD_OP_SNAPSHOT:
+			if(hdr->len != 8 + 4 * (uint32_t) a->rr.count) {
+				agent_fail(a, "malformed snapshot");
+				return 0;
+			}
+			agent_print(a, payload + 8, a->rr.count, NULL);
+			a->stop = now;
+			a->state = AG_DONE;
+			return 0;
+
+		case DD_OP_READ_BATCH:
+			if(hdr->len != 4 + 4 * (uint32_t) a->n) {
+				agent_fail(a, "malformed batch reply");
+				return 0;
+			}
+
+			if(cmd == CMD_READ) {
+				agent_print(a, payload + 4, a->n, a->idx);
+				a->state = AG_DONE;
+				return 0;
+			}
+
+			if(a->done >= a->lat_size) {
+				a->lat_size = a->lat_size ? 2 * a->lat_size : 4096;
+				if((a->lat = realloc(a->lat, a->lat_size * sizeof(uint32_t))) == NULL)
+					return -1;
+			}
+			now -= a->sent_ns[a->done % RM_WINDOW];
+			a->lat[a->done++] = now > UINT32_MAX ? UINT32_MAX : now;
+
+			if(a->last < a->stop)
+				return agent_send_batch(a);
+			if(a->done == a->sent) {
+				a->stop = a->last;
+				a->state = AG_DONE;
+			}
+			return 0;
+	}
+
+	return 0;
+}
+
+static int agent_input(struct agent *a) {
+	struct dd_hdr hdr;
+	size_t off = 0;
+	ssize_t n;
+
+	if(dd_reserve(&a->in, &a->in_size, a->in_len, 65536) == -1)
+		return -1;
+
+	n = read(a->fd, a->in + a->in_len, a->in_size - a->in_len);
+	if(n < 0)
+		return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+	if(n == 0) {
+		errno = ECONNRESET;
+		return -1;
+	}
+	a->in_len += n;
+
+	while(a->state == AG_RUNNING && a->in_len - off >= DD_HDR_SIZE) {
+		dd_get_hdr(a->in + off, &hdr);
+		if(hdr.magic != DD_MAGIC || hdr.len > DD_MAX_PAYLOAD) {
+			errno = EPROTO;
+			return -1;
+		}
+		if(a->in_len - off < DD_HDR_SIZE + hdr.len)
+			break;
+
+		if(agent_reply(a, &hdr, a->in + off + DD_HDR_SIZE) == -1)
+			return -1;
+		off += DD_HDR_SIZE + hdr.len;
+	}
+
+	memmove(a->in, a->in + off, a->in_len - off);
+	a->in_len -= off;
+	return 0;
+}
+
+static int agent_output(struct agent *a) {
+	ssize_t n;
+
+	while(a->out_off < a->out_len) {
+		n = send(a->fd, a->out + a->out_off, a->out_len - a->out_off, MSG_NOSIGNAL);
+		if(n < 0)
+			return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+		a->out_off += n;
+	}
+
+	a->out_off = a->out_len = 0;
+	return 0;
+}
+
+static int agent_connected(struct agent *a) {
+	int err = 0;
+	socklen_t len = sizeof(err);
+
+	if(getsockopt(a->fd, SOL_SOCKET, SO_ERROR, &err, &len) == -1 || err != 0) {
+		errno = err ? err : errno;
+		return -1;
+	}
+
+	a->state = AG_RUNNING;
+	a->last = now_ns();
+	return agent_send(a, DD_OP_INFO, NULL, 0);
+}
+
+static int lat_cmp(const void *a, const void *b) {
+	uint32_t x = *(const uint32_t *) a, y = *(const uint32_t *) b;
+
+	return x < y ? -1 : x > y;
+}
+
+static void bench_report(void) {
+	uint64_t first = 0, last = 0, reads = 0, batches = 0;
+	int i, ok = 0;
+
+	printf("%-24s %10s %12s %10s %10s %10s %10s\n", "agent", "batches",
+	       "reads/s", "avg us", "p50 us", "p99 us", "max us");
+
+	for(i = 0; i < num_agents; i++) {
+		struct agent *a = &agents[i];
+		uint64_t sum = 0;
+		long j;
+
+		if(a->state != AG_DONE || a->done == 0)
+			continue;
+
+		qsort(a->lat, a->done, sizeof(uint32_t), lat_cmp);
+		for(j = 0; j < a->done; j++)
+			sum += a->lat[j];
+
+		printf("%-24s %10ld %12.0f %10.1f %10.1f %10.1f %10.1f\n", a->endpoint, a->done,
+		       a->done * (double) a->n / ((a->stop - a->start) / 1e9),
+		       sum / 1e3 / a->done, a->lat[a->done / 2] / 1e3,
+		       a->lat[a->done * 99 / 100] / 1e3, a->lat[a->done - 1] / 1e3);
+
+		if(ok++ == 0 || a->start < first)
+			first = a->start;
+		if(a->stop > last)
+			last = a->stop;
+		batches += a->done;
+		reads += a->done * (uint64_t) a->n;
+	}
+
+	if(ok > 0)
+		printf("%d agents: %.0f batches/s, %.0f reads/s\n", ok,
+		       batches / ((last - first) / 1e9), reads / ((last - first) / 1e9));
+}
+
+/*
+ * Runs a client command on several daemons concurrently
+ * Input:
+ *	const char *endpoints	- daemon endpoints separated by commas
+ *	int argc, char **argv	- read { reg }..., snapshot,
+ *				  bench [seconds [batch size]]
+ *
+ * Output:
+ *	exit status of the program, 1 if any agent failed
+ */
+int run_remote(const char *endpoints, int argc, char **argv) {
+	struct pollfd pfds[RM_MAX_AGENTS];
+	char *list, *tok, *save;
+	uint64_t now;
+	int i, n, active, ret = 0;
+
+	if(strcmp(argv[0], "read") == 0 && argc > 1)
+		cmd = CMD_READ;
+	else if(strcmp(argv[0], "snapshot") == 0)
+		cmd = CMD_SNAPSHOT;
+	else if(strcmp(argv[0], "bench") == 0)
+		cmd = CMD_BENCH;
+	else {
+		fprintf(stderr, "devicedbg: %s is not available on several daemons\n", argv[0]);
+		return 1;
+	}
+
+	cmd_argc = argc - 1;
+	cmd_argv = argv + 1;
+	bench_seconds = cmd == CMD_BENCH && argc > 1 ? atof(argv[1]) : 1.0;
+	bench_batch = cmd == CMD_BENCH && argc > 2 ? atoi(argv[2]) : 64;
+	if(bench_batch <= 0)
+		bench_batch = 1;
+
+	if((list = strdup(endpoints)) == NULL) FATAL;
+	signal(SIGPIPE, SIG_IGN);
+
+	for(tok = strtok_r(list, ",", &save); tok != NULL; tok = strtok_r(NULL, ",", &save)) {
+		struct agent *a = &agents[num_agents];
+
+		if(num_agents == RM_MAX_AGENTS) {
+			fprintf(stderr, "devicedbg: too many agents\n");
+			break;
+		}
+
+		memset(a, 0, sizeof(*a));
+		a->endpoint = tok;
+		a->last = now_ns();
+		if((a->fd = net_connect(tok, 1)) == -1)
+			agent_fail(a, strerror(errno));
+		num_agents++;
+	}
+
+	for(;;) {
+		now = now_ns();
+		for(i = active = 0; i < num_agents; i++) {
+			struct agent *a = &agents[i];
+
+			if(a->state == AG_CONNECTING || a->state == AG_RUNNING) {
+				if(now - a->last > RM_TIMEOUT)
+					agent_fail(a, "timed out");
+				else
+					active++;
+			}
+
+			pfds[i].fd = a->state == AG_CONNECTING || a->state == AG_RUNNING ? a->fd : -1;
+			pfds[i].events = a->state == AG_RUNNING ? POLLIN : 0;
+			if(a->state == AG_CONNECTING || a->out_off < a->out_len)
+				pfds[i].events |= POLLOUT;
+		}
+
+		if(active == 0)
+			break;
+
+		if((n = poll(pfds, num_agents, 1000)) == -1) {
+			if(errno == EINTR)
+				continue;
+			FATAL;
+		}
+
+		for(i = 0; i < num_agents && n > 0; i++) {
+			struct agent *a = &agents[i];
+			short ev = pfds[i].revents;
+			int err = 0;
+
+			if(ev == 0)
+				continue;
+
+			if(a->state == AG_CONNECTING)
+				err = agent_connected(a) == -1;
+			else if(ev & (POLLIN | POLLHUP | POLLERR))
+				err = agent_input(a) == -1;
+
+			if(!err && a->state == AG_RUNNING && a->out_off < a->out_len)
+				err = agent_output(a) == -1;
+
+			if(err)
+				agent_fail(a, strerror(errno));
+		}
+	}
+
+	if(cmd == CMD_BENCH)
+		bench_report();
+
+	for(i = 0; i < num_agents; i++) {
+		struct agent *a = &agents[i];
+
+		ret |= a->state != AG_DONE;
+		if(a->fd >= 0)
+			close(a->fd);
+		if(a->rr.entries != NULL)
+			registry_free(&a->rr);
+		free(a->in);
+		free(a->out);
+		free(a->req);
+		free(a->idx);
+		free(a->lat);
+	}
+
+	free(list);
+	return ret;
+}
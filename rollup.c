@@ -0,0 +1,482 @@
+/*
+ * rollup.c : bounded-memory history of every register kept by the daemon
+ *
+ * Raw samples cannot be kept for weeks in the field, so the daemon folds them
+ * into windows of 1 second, 1 minute and 1 hour. A window holds, for every
+ * register, the last, lowest and highest value and the number of samples in
+ * which the register changed. Each tier is a ring of a fixed number of closed
+ * windows plus the window being filled: a closed second is merged into the
+ * current minute, a closed minute into the current hour, and the oldest
+ * windows of a full ring are overwritten. Memory is set once at startup,
+ * from a number of windows per tier or from a byte budget. All the tiers
+ * keep the same number of windows, N of them cover N seconds, N minutes and
+ * N hours.
+ *
+ * Windows are aligned on CLOCK_REALTIME so that they match wall clock minutes
+ * and hours. A window in which the daemon took no sample does not exist, gaps
+ * show in the start times.
+ *
+ * The rings can be saved to a file at every closed minute and on exit, and
+ * are restored at startup when the file matches the registry and the
+ * retention. The file is written whole once, through a temporary file, then
+ * only the windows closed since the last save and the windows being filled
+ * are written in place: about 60 windows of the 1 second tier a minute,
+ * whatever the retention. The file is in host byte order, it is meant to
+ * survive a restart of the daemon, not to be exchanged.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <ctype.h>
+#include <fcntl.h>
+
+#include "devicedbg.h"
+#include "proto.h"
+
+#define RU_MAGIC	0x52554444	/* "DDRU" */
+#define RU_VERSION	1
+
+struct ru_cell {
+	uint32_t last, min, max, changes;
+};
+
+struct ru_tier {
+	uint32_t period;		/* seconds */
+	uint32_t head, len;		/* next slot to write, closed windows */
+	uint32_t *start;		/* [slots] window start, seconds since the epoch */
+	uint32_t *samples;		/* [slots] samples taken in the window */
+	struct ru_cell *cells;		/* [slots][count] */
+	uint32_t acc_start, acc_samples;	/* window being filled */
+	struct ru_cell *acc;		/* [count] */
+	uint32_t unsaved;		/* windows closed since the last save */
+};
+
+struct ru_file_hdr {
+	uint32_t magic, version, hash, count, slots, tiers;
+};
+
+static const uint32_t ru_periods[RU_TIERS] = { 1, 60, 3600 };
+
+static struct ru_tier tiers[RU_TIERS];
+static const struct reg_registry *ru_registry;
+static uint32_t ru_slots;
+static uint32_t *ru_prev;		/* previous sample, for the change counts */
+static int ru_prev_valid;
+static const char *ru_path;
+static int ru_fd = -1;			/* rollup file as last saved, -1 to rewrite it */
+static int ru_save_due;			/* a minute closed, save once the sample is in */
+
+/* Number of closed windows per tier from "N" windows or a "N{K,M,G}" byte budget
+ * Output:
+ *	windows, 0 if the retention is malformed
+ */
+static uint32_t rollup_slots(const char *retention, int count) {
+	unsigned long long n, per_window;
+	char *end;
+
+	n = strtoull(retention, &end, 10);
+	if(end == retention)
+		return 0;
+
+	per_window = RU_TIERS * (8 + sizeof(struct ru_cell) * (unsigned long long) count);
+	switch(toupper(*end)) {
+		case '\0':
+			return n > UINT32_MAX ? 0 : n;
+		case 'K':
+			n <<= 10;
+			break;
+		case 'M':
+			n <<= 20;
+			break;
+		case 'G':
+			n <<= 30;
+			break;
+		default:
+			return 0;
+	}
+
+	if(end[1] != '\0' || n / per_window > UINT32_MAX)
+		return 0;
+	return n / per_window;
+}
+
+static void cell_open(struct ru_cell *c, const struct ru_cell *from) {
+	c->last = c->min = c->max = from->last;
+	c->changes = from->changes;
+}
+
+static void cell_merge(struct ru_cell *c, const struct ru_cell *from) {
+	c->last = from->last;
+	if(from->min < c->min)
+		c->min = from->min;
+	if(from->max > c->max)
+		c->max = from->max;
+	c->changes += from->changes;
+}
+
+/* Folds a closed window of tier t - 1 into the window being filled of tier t */
+static void tier_merge(int t, uint32_t start, uint32_t samples, const struct ru_cell *cells);
+
+/* Moves the window being filled of tier t to its ring and up to tier t + 1 */
+static void tier_close(int t) {
+	struct ru_tier *tr = &tiers[t];
+	uint32_t start, samples;
+
+	if(tr->acc_samples == 0)
+		return;
+
+	tr->start[tr->head] = tr->acc_start;
+	tr->samples[tr->head] = tr->acc_samples;
+	memcpy(tr->cells + (size_t) tr->head * ru_registry->count, tr->acc,
+	       ru_registry->count * sizeof(struct ru_cell));
+	tr->head = (tr->head + 1) % ru_slots;
+	if(tr->len < ru_slots)
+		tr->len++;
+	if(tr->unsaved < ru_slots)
+		tr->unsaved++;
+
+	// the window is in the ring, it is no longer being filled when the
+	// tiers above close and merge in turn
+	start = tr->acc_start;
+	samples = tr->acc_samples;
+	tr->acc_samples = 0;
+	if(t + 1 < RU_TIERS)
+		tier_merge(t + 1, start, samples, tr->acc);
+
+	// one save per minute, once the closed second is in the new minute too
+	if(t == 1 && ru_path != NULL)
+		ru_save_due = 1;
+}
+
+static void tier_merge(int t, uint32_t start, uint32_t samples, const struct ru_cell *cells) {
+	struct ru_tier *tr = &tiers[t];
+	int i;
+
+	start -= start % tr->period;
+	if(tr->acc_samples > 0 && tr->acc_start != start)
+		tier_close(t);
+
+	for(i = 0; i < ru_registry->count; i++) {
+		if(tr->acc_samples == 0)
+			cell_open(&tr->acc[i], &cells[i]);
+		else
+			cell_merge(&tr->acc[i], &cells[i]);
+	}
+
+	tr->acc_start = start;
+	tr->acc_samples += samples;
+}
+
+/*
+ * Adds one sample of every register to the 1 second tier
+ * Input:
+ *	const uint32_t *values	- registry order
+ */
+void rollup_add(const uint32_t *values) {
+	struct ru_tier *tr = &tiers[0];
+	struct timespec ts;
+	uint32_t now;
+	int i;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	now = ts.tv_sec;
+
+	if(tr->acc_samples > 0 && tr->acc_start != now)
+		tier_close(0);
+	if(ru_save_due) {
+		ru_save_due = 0;
+		rollup_save();
+	}
+
+	for(i = 0; i < ru_registry->count; i++) {
+		struct ru_cell *c = &tr->acc[i];
+		uint32_t changed = ru_prev_valid && values[i] != ru_prev[i];
+
+		if(tr->acc_samples == 0) {
+			c->last = c->min = c->max = values[i];
+			c->changes = changed;
+			continue;
+		}
+
+		c->last = values[i];
+		if(values[i] < c->min)
+			c->min = values[i];
+		if(values[i] > c->max)
+			c->max = values[i];
+		c->changes += changed;
+	}
+
+	tr->acc_start = now;
+	tr->acc_samples++;
+
+	memcpy(ru_prev, values, ru_registry->count * sizeof(uint32_t));
+	ru_prev_valid = 1;
+}
+
+/* Closed windows of a tier a query returns, the latest max ones */
+uint32_t rollup_windows(int tier, uint32_t max) {
+	if(tier < 0 || tier >= RU_TIERS)
+		return 0;
+	return tiers[tier].len < max ? tiers[tier].len : max;
+}
+
+/*
+ * Encodes the latest n closed windows of one register, oldest first, as
+ * the payload of a DD_OP_ROLLUP reply (see proto.h)
+ * Input:
+ *	int tier, index		- tier and registry index
+ *	uint32_t n		- windows, at most rollup_windows(tier, n)
+ *	uint8_t *p		- receives 8 + 24 * n bytes
+ */
+void rollup_encode(int tier, int index, uint32_t n, uint8_t *p) {
+	const struct ru_tier *tr = &tiers[tier];
+	uint32_t i, slot;
+
+	dd_put32(p, tr->period);
+	dd_put32(p + 4, n);
+
+	for(i = 0, p += 8; i < n; i++, p += 24) {
+		const struct ru_cell *c;
+
+		slot = (tr->head + ru_slots - n + i) % ru_slots;
+		c = &tr->cells[(size_t) slot * ru_registry->count + index];
+
+		dd_put32(p, tr->start[slot]);
+		dd_put32(p + 4, tr->samples[slot]);
+		dd_put32(p + 8, c->last);
+		dd_put32(p + 12, c->min);
+		dd_put32(p + 16, c->max);
+		dd_put32(p + 20, c->changes);
+	}
+}
+
+/* Reads or writes the state of the tiers after the file header
+ * Output:
+ *	0 on success, -1 on a short transfer
+ */
+static int rollup_io(FILE *f, int save) {
+	size_t count = ru_registry->count;
+	int t;
+
+#define RU_IO(ptr, size) \
+	if((save ? fwrite((ptr), (size), 1, f) : fread((ptr), (size), 1, f)) != 1) \
+		return -1
+
+	for(t = 0; t < RU_TIERS; t++) {
+		struct ru_tier *tr = &tiers[t];
+
+		RU_IO(&tr->head, sizeof(tr->head));
+		RU_IO(&tr->len, sizeof(tr->len));
+		RU_IO(&tr->acc_start, sizeof(tr->acc_start));
+		RU_IO(&tr->acc_samples, sizeof(tr->acc_samples));
+		RU_IO(tr->start, ru_slots * sizeof(uint32_t));
+		RU_IO(tr->samples, ru_slots * sizeof(uint32_t));
+		RU_IO(tr->cells, ru_slots * count * sizeof(struct ru_cell));
+		RU_IO(tr->acc, count * sizeof(struct ru_cell));
+	}
+#undef RU_IO
+
+	return 0;
+}
+
+/* Writes n windows of a tier from slot first, in place */
+static int rollup_write_slots(const struct ru_tier *tr, off_t base, uint32_t first, uint32_t n) {
+	size_t row = ru_registry->count * sizeof(struct ru_cell);
+	off_t start = base + 4 * sizeof(uint32_t);
+	off_t samples = start + ru_slots * sizeof(uint32_t);
+	off_t cells = samples + ru_slots * sizeof(uint32_t);
+
+	if(n == 0)
+		return 0;
+
+	if(pwrite(ru_fd, tr->start + first, n * sizeof(uint32_t),
+		  start + first * sizeof(uint32_t)) != (ssize_t) (n * sizeof(uint32_t)) ||
+	   pwrite(ru_fd, tr->samples + first, n * sizeof(uint32_t),
+		  samples + first * sizeof(uint32_t)) != (ssize_t) (n * sizeof(uint32_t)) ||
+	   pwrite(ru_fd, tr->cells + (size_t) first * ru_registry->count, n * row,
+		  cells + (off_t) first * row) != (ssize_t) (n * row))
+		return -1;
+
+	return 0;
+}
+
+/*
+ * Writes the windows closed since the last save and the windows being
+ * filled to the rollup file, at their place in the layout of rollup_io()
+ * Output:
+ *	0 on success, -1 on a write error
+ */
+static int rollup_update(void) {
+	size_t row = ru_registry->count * sizeof(struct ru_cell);
+	off_t base = sizeof(struct ru_file_hdr);
+	uint32_t first, n, state[4];
+	int t;
+
+	for(t = 0; t < RU_TIERS; t++) {
+		const struct ru_tier *tr = &tiers[t];
+
+		// the unsaved windows end at head, once around the ring at most
+		first = (tr->head + ru_slots - tr->unsaved) % ru_slots;
+		n = tr->unsaved < ru_slots - first ? tr->unsaved : ru_slots - first;
+		if(rollup_write_slots(tr, base, first, n) == -1 ||
+		   rollup_write_slots(tr, base, 0, tr->unsaved - n) == -1)
+			return -1;
+
+		// the state last: a save cut short leaves the previous heads, at
+		// worst with some of the oldest windows replaced by newer ones
+		state[0] = tr->head;
+		state[1] = tr->len;
+		state[2] = tr->acc_start;
+		state[3] = tr->acc_samples;
+		if(pwrite(ru_fd, tr->acc, row, base + 4 * sizeof(uint32_t) +
+			  2 * ru_slots * sizeof(uint32_t) + (off_t) ru_slots * row) != (ssize_t) row ||
+		   pwrite(ru_fd, state, sizeof(state), base) != sizeof(state))
+			return -1;
+
+		base += sizeof(state) + 2 * ru_slots * sizeof(uint32_t) + (off_t) (ru_slots + 1) * row;
+	}
+
+	return 0;
+}
+
+/* Writes the tiers to the rollup file: in place when it is the file last
+ * saved, otherwise whole, replacing it only once complete */
+void rollup_save(void) {
+	struct ru_file_hdr hdr = { RU_MAGIC, RU_VERSION, ru_registry->hash, ru_registry->count,
+				   ru_slots, RU_TIERS };
+	char tmp[4096];
+	FILE *f;
+	int t;
+
+	if(ru_fd != -1) {
+		if(rollup_update() == 0) {
+			for(t = 0; t < RU_TIERS; t++)
+				tiers[t].unsaved = 0;
+			return;
+		}
+		fprintf(stderr, "devicedbg: %s: %s, rewritten\n", ru_path, strerror(errno));
+		close(ru_fd);
+		ru_fd = -1;
+	}
+
+	snprintf(tmp, sizeof(tmp), "%s.tmp", ru_path);
+	if((f = fopen(tmp, "w")) == NULL) {
+		fprintf(stderr, "devicedbg: %s: %s\n", tmp, strerror(errno));
+		return;
+	}
+
+	if(fwrite(&hdr, sizeof(hdr), 1, f) != 1 || rollup_io(f, 1) == -1) {
+		fprintf(stderr, "devicedbg: %s: %s\n", tmp, strerror(errno));
+		fclose(f);
+		unlink(tmp);
+		return;
+	}
+
+	if(fclose(f) == EOF || rename(tmp, ru_path) == -1) {
+		fprintf(stderr, "devicedbg: %s: %s\n", ru_path, strerror(errno));
+		unlink(tmp);
+		return;
+	}
+
+	for(t = 0; t < RU_TIERS; t++)
+		tiers[t].unsaved = 0;
+	ru_fd = open(ru_path, O_WRONLY);
+}
+
+/* Restores the tiers from the rollup file if it has the same layout */
+static void rollup_load(void) {
+	struct ru_file_hdr hdr;
+	FILE *f;
+	int t;
+
+	if((f = fopen(ru_path, "r")) == NULL)
+		return;
+
+	if(fread(&hdr, sizeof(hdr), 1, f) != 1 || hdr.magic != RU_MAGIC ||
+	   hdr.version != RU_VERSION || hdr.hash != ru_registry->hash ||
+	   hdr.count != (uint32_t) ru_registry->count || hdr.slots != ru_slots ||
+	   hdr.tiers != RU_TIERS) {
+		fprintf(stderr, "devicedbg: %s: other registers or retention, history restarts\n",
+			ru_path);
+		fclose(f);
+		return;
+	}
+
+	if(rollup_io(f, 0) == -1) {
+		fprintf(stderr, "devicedbg: %s: truncated, history restarts\n", ru_path);
+		for(t = 0; t < RU_TIERS; t++)
+			tiers[t].head = tiers[t].len = tiers[t].acc_samples = 0;
+	}
+	else
+		ru_fd = open(ru_path, O_WRONLY);
+
+	fclose(f);
+}
+
+/*
+ * Allocates the tiers
+ * Input:
+ *	const struct reg_registry *rr	- registry of the sampled registers
+ *	const char *retention		- closed windows per tier, or a byte budget
+ *					  for all the tiers with a K, M or G suffix
+ *	const char *path		- file the tiers are saved to, or NULL
+ *
+ * Output:
+ *	0 on success, -1 if the retention is malformed
+ */
+int rollup_init(const struct reg_registry *rr, const char *retention, const char *path) {
+	int t;
+
+	if((ru_slots = rollup_slots(retention, rr->count)) == 0) {
+		fprintf(stderr, "devicedbg: bad retention %s, windows or bytes with K, M or G\n",
+			retention);
+		return -1;
+	}
+
+	ru_registry = rr;
+	ru_path = path;
+	if((ru_prev = malloc(rr->count * sizeof(uint32_t))) == NULL) FATAL;
+
+	for(t = 0; t < RU_TIERS; t++) {
+		struct ru_tier *tr = &tiers[t];
+
+		memset(tr, 0, sizeof(*tr));
+		tr->period = ru_periods[t];
+		tr->start = calloc(ru_slots, sizeof(uint32_t));
+		tr->samples = calloc(ru_slots, sizeof(uint32_t));
+		tr->cells = calloc((size_t) ru_slots * rr->count, sizeof(struct ru_cell));
+		tr->acc = calloc(rr->count, sizeof(struct ru_cell));
+		if(tr->start == NULL || tr->samples == NULL || tr->cells == NULL || tr->acc == NULL)
+			FATAL;
+	}
+
+	if(path != NULL)
+		rollup_load();
+
+	printf("rollups: %u windows of 1 s, 1 min and 1 h, %.1f MB\n", ru_slots,
+	       RU_TIERS * (double) ru_slots * (8 + sizeof(struct ru_cell) * rr->count) / 1048576);
+	return 0;
+}
+
+/* Saves the tiers one last time and frees them */
+void rollup_close(void) {
+	int t;
+
+	if(ru_path != NULL)
+		rollup_save();
+	if(ru_fd != -1)
+		close(ru_fd);
+	ru_fd = -1;
+
+	for(t = 0; t < RU_TIERS; t++) {
+		free(tiers[t].start);
+		free(tiers[t].samples);
+		free(tiers[t].cells);
+		free(tiers[t].acc);
+	}
+	free(ru_prev);
+	ru_registry = NULL;
+}
@@ -0,0 +1,516 @@
+/*
+ * script.c : register sequence scripts
+ *
+ * Bring-up and reproduction recipes are short sequences of accesses, e.g.
+ * enabling a module, waiting for its reset and configuring it. A script has
+ * one statement per line, '#' starts a comment:
+ *
+ *	read UART1.LCR[:FIELD]			print a register or a field
+ *	write 0x44E004B4 0x2			write a whole register
+ *	set UART1.SYSC 0x2			OR of bits, read-modify-write
+ *	clear TIMER2.TCLR 0x1			AND NOT of bits
+ *	field UART1.LCR:CHAR_LENGTH 8BITS	one field, by value or value name
+ *	poll UART1.SYSS 0x1 0x1 10ms		until (reg & mask) == value
+ *	delay 50us				wait
+ *	assert UART1.LCR:CHAR_LENGTH 8BITS	stop unless (reg & mask) == value
+ *
+ * poll and assert take a mask and a value, or a field and its value. Times
+ * are in us, ms or s, us without a unit. Registers are "INSTANCE.REGISTER"
+ * names or physical addresses; addresses outside the tables (the clock
+ * manager) are allowed, as 32 bit registers without side effects on read.
+ *
+ * The script is compiled before it runs: names and fields are resolved,
+ * the registers mapped, and the statements turned into a bytecode of 32 bit
+ * words, an instruction word (opcode and register slot) followed by its
+ * operands:
+ *
+ *	SC_READ		slot	mask, shift
+ *	SC_WRITE	slot	value
+ *	SC_RMW		slot	mask, value
+ *	SC_POLL		slot	mask, value, timeout (us)
+ *	SC_DELAY	-	time (us)
+ *	SC_ASSERT	slot	mask, value
+ *
+ * The executor is a loop over the words with the registers in an array of
+ * mapped addresses, nothing is looked up or printed while it runs. Every
+ * step is timed and its value kept, the trace is printed at the end. Delays
+ * spin on the monotonic clock for the last 100 us, so steps are timed to the
+ * microsecond. A failed poll or assert, or a bus error, stops the script.
+ *
+ * The module clocks are not checked before a script: enabling them is
+ * usually what it does first.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <time.h>
+
+#include "devicedbg.h"
+
+#define SCRIPT_LINE		256
+#define SCRIPT_SPIN_NS		100000ULL	/* delays spin for the last 100 us */
+
+enum { SC_READ, SC_WRITE, SC_RMW, SC_POLL, SC_DELAY, SC_ASSERT };
+
+/* one executed instruction, for the trace */
+struct script_step {
+	int line;				/* in the script */
+	const char *what;			/* statement */
+	int pc;					/* its instruction word */
+	uint32_t value;				/* read, written or last polled */
+	uint32_t polls;
+	uint64_t ns;				/* duration */
+};
+
+/* compiled script */
+struct script {
+	uint32_t *code;
+	int len, max;
+	volatile uint32_t **virt;		/* registers by slot */
+	unsigned long *addr;
+	int *entry;				/* registry index, -1 outside the tables */
+	int num_regs, max_regs;
+	struct script_step *steps;		/* one per instruction */
+	int num_steps, max_steps;
+};
+
+static void script_emit(struct script *sc, uint32_t word) {
+	if(sc->len == sc->max) {
+		sc->max = sc->max ? 2 * sc->max : 64;
+		if((sc->code = realloc(sc->code, sc->max * sizeof(uint32_t))) == NULL) FATAL;
+	}
+	sc->code[sc->len++] = word;
+}
+
+/* Starts an instruction of a line */
+static void script_insn(struct script *sc, int op, int slot, int line, const char *what) {
+	if(sc->num_steps == sc->max_steps) {
+		sc->max_steps = sc->max_steps ? 2 * sc->max_steps : 32;
+		if((sc->steps = realloc(sc->steps, sc->max_steps * sizeof(struct script_step))) == NULL)
+			FATAL;
+	}
+	memset(&sc->steps[sc->num_steps], 0, sizeof(struct script_step));
+	sc->steps[sc->num_steps].line = line;
+	sc->steps[sc->num_steps].what = what;
+	sc->steps[sc->num_steps++].pc = sc->len;
+
+	script_emit(sc, op | slot << 8);
+}
+
+/* Slot of a register, each register has one */
+static int script_slot(struct script *sc, unsigned long addr, int entry) {
+	int i;
+
+	for(i = 0; i < sc->num_regs && sc->addr[i] != addr; i++)
+		;
+	if(i < sc->num_regs)
+		return i;
+
+	if(sc->num_regs == sc->max_regs) {
+		sc->max_regs = sc->max_regs ? 2 * sc->max_regs : 16;
+		sc->virt = realloc((void *) sc->virt, sc->max_regs * sizeof(volatile uint32_t *));
+		sc->addr = realloc(sc->addr, sc->max_regs * sizeof(unsigned long));
+		sc->entry = realloc(sc->entry, sc->max_regs * sizeof(int));
+		if(sc->virt == NULL || sc->addr == NULL || sc->entry == NULL) FATAL;
+	}
+
+	sc->virt[i] = mem_map(addr);
+	sc->addr[i] = addr;
+	sc->entry[i] = entry;
+	return sc->num_regs++;
+}
+
+static void script_free(struct script *sc) {
+	free(sc->code);
+	free((void *) sc->virt);
+	free(sc->addr);
+	free(sc->entry);
+	free(sc->steps);
+	memset(sc, 0, sizeof(*sc));
+}
+
+static int script_number(const char *s, uint32_t *v) {
+	unsigned long long n;
+	char *end;
+
+	errno = 0;
+	n = strtoull(s, &end, 0);
+	if(end == s || *end != '\0' || errno != 0 || n > UINT32_MAX)
+		return -1;
+
+	*v = n;
+	return 0;
+}
+
+/* Parses a time, "10us", "5ms", "1s" or microseconds */
+static int script_time(const char *s, uint32_t *us) {
+	unsigned long long n;
+	char *end;
+
+	errno = 0;
+	n = strtoull(s, &end, 10);
+	if(end == s || errno != 0)
+		return -1;
+
+	if(strcmp(end, "s") == 0)
+		n *= 1000000;
+	else if(strcmp(end, "ms") == 0)
+		n *= 1000;
+	else if(*end != '\0' && strcmp(end, "us") != 0)
+		return -1;
+
+	if(n > UINT32_MAX)
+		return -1;
+	*us = n;
+	return 0;
+}
+
+/*
+ * Resolves a register, with a field after a ':'
+ * Input:
+ *	char *arg			- "UART1.LCR", "0x44E0006C" or "UART1.LCR:CHAR_LENGTH"
+ *	int reads			- the statement reads the register
+ *	int *slot			- receives the register slot
+ *	const struct reg_field **field	- receives the field, NULL without one
+ *
+ * Output:
+ *	NULL on success, or what is wrong
+ */
+static const char *script_target(const struct reg_registry *rr, struct script *sc, char *arg,
+				 int reads, int *slot, const struct reg_field **field) {
+	char *colon = strrchr(arg, ':');
+	unsigned long addr;
+	uint32_t a;
+	int entry;
+
+	*field = NULL;
+	if(colon != NULL)
+		*colon = '\0';
+
+	if((entry = registry_lookup(rr, arg)) >= 0)
+		addr = rr->entries[entry].addr;
+	else if(script_number(arg, &a) == 0 && (a & 3) == 0)
+		addr = a;
+	else
+		return "unknown register";
+
+	if(colon != NULL && (entry < 0 || (*field = reg_find_field(rr->entries[entry].reg,
+								    colon + 1)) == NULL))
+		return "unknown field";
+
+	// polling or reading back a FIFO would take the data of the driver
+	if(reads && entry >= 0 && !plan_readable(rr->entries[entry].reg))
+		return rr->entries[entry].reg->access == REG_WRITE_ONLY ? "write-only register" :
+		       "side effects on read, -X reads it";
+
+	*slot = script_slot(sc, addr, entry);
+	return NULL;
+}
+
+/*
+ * Parses a mask and a value, or the value of a field
+ * Output:
+ *	number of words used, -1 if they are wrong
+ */
+static int script_match(const struct reg_field *field, char **argv, int argc,
+			uint32_t *mask, uint32_t *value) {
+	if(field != NULL) {
+		*mask = reg_field_mask(field);
+		return argc >= 1 && reg_field_value(field, argv[0], value) == 0 ? 1 : -1;
+	}
+
+	if(argc < 2 || script_number(argv[0], mask) == -1 || script_number(argv[1], value) == -1)
+		return -1;
+	*value &= *mask;
+	return 2;
+}
+
+/*
+ * Compiles one statement
+ * Output:
+ *	NULL on success, or what is wrong
+ */
+static const char *script_statement(const struct reg_registry *rr, struct script *sc,
+				    char **argv, int argc, int line) {
+	const struct reg_field *f;
+	uint32_t mask, value, t;
+	const char *why;
+	int slot, n;
+
+	if(strcasecmp(argv[0], "delay") == 0) {
+		if(argc != 2 || script_time(argv[1], &t) == -1)
+			return "delay takes a time";
+		script_insn(sc, SC_DELAY, 0, line, "delay");
+		script_emit(sc, t);
+		return NULL;
+	}
+
+	if(argc < 2)
+		return "missing register";
+
+	if(strcasecmp(argv[0], "read") == 0) {
+		if(argc != 2)
+			return "read takes a register";
+		if((why = script_target(rr, sc, argv[1], 1, &slot, &f)) != NULL)
+			return why;
+		script_insn(sc, SC_READ, slot, line, "read");
+		script_emit(sc, f ? reg_field_mask(f) : ~0U);
+		script_emit(sc, f ? f->shift : 0);
+	}
+	else if(strcasecmp(argv[0], "write") == 0) {
+		if(argc != 3 || (why = script_target(rr, sc, argv[1], 0, &slot, &f)) != NULL ||
+		   f != NULL || script_number(argv[2], &value) == -1)
+			return argc != 3 ? "write takes a register and a value" :
+			       why ? why : f ? "write takes a whole register, field for a field" :
+			       "bad value";
+		script_insn(sc, SC_WRITE, slot, line, "write");
+		script_emit(sc, value);
+	}
+	else if(strcasecmp(argv[0], "set") == 0 || strcasecmp(argv[0], "clear") == 0) {
+		if(argc != 3 || (why = script_target(rr, sc, argv[1], 1, &slot, &f)) != NULL ||
+		   f != NULL || script_number(argv[2], &mask) == -1)
+			return argc != 3 ? "set and clear take a register and bits" :
+			       why ? why : f ? "set and clear take a whole register" : "bad bits";
+		script_insn(sc, SC_RMW, slot, line, strcasecmp(argv[0], "set") == 0 ? "set" : "clear");
+		script_emit(sc, mask);
+		script_emit(sc, strcasecmp(argv[0], "set") == 0 ? mask : 0);
+	}
+	else if(strcasecmp(argv[0], "field") == 0) {
+		if(argc != 3 || (why = script_target(rr, sc, argv[1], 1, &slot, &f)) != NULL ||
+		   f == NULL || reg_field_value(f, argv[2], &value) == -1)
+			return argc != 3 ? "field takes a register:field and a value" :
+			       why ? why : f == NULL ? "field takes a register:field" : "bad field value";
+		script_insn(sc, SC_RMW, slot, line, "field");
+		script_emit(sc, reg_field_mask(f));
+		script_emit(sc, value);
+	}
+	else if(strcasecmp(argv[0], "poll") == 0) {
+		if((why = script_target(rr, sc, argv[1], 1, &slot, &f)) != NULL)
+			return why;
+		if((n = script_match(f, argv + 2, argc - 2, &mask, &value)) == -1 ||
+		   argc != 3 + n || script_time(argv[2 + n], &t) == -1)
+			return "poll takes a register, a mask and a value (or register:field and a "
+			       "value), and a timeout";
+		script_insn(sc, SC_POLL, slot, line, "poll");
+		script_emit(sc, mask);
+		script_emit(sc, value);
+		script_emit(sc, t);
+	}
+	else if(strcasecmp(argv[0], "assert") == 0) {
+		if((why = script_target(rr, sc, argv[1], 1, &slot, &f)) != NULL)
+			return why;
+		if((n = script_match(f, argv + 2, argc - 2, &mask, &value)) == -1 || argc != 2 + n)
+			return "assert takes a register, a mask and a value (or register:field and a value)";
+		script_insn(sc, SC_ASSERT, slot, line, "assert");
+		script_emit(sc, mask);
+		script_emit(sc, value);
+	}
+	else
+		return "unknown statement";
+
+	return NULL;
+}
+
+/*
+ * Compiles a script
+ * Input:
+ *	const char *path	- script file, "-" for the standard input
+ *
+ * Output:
+ *	0 on success, -1 on error, the reason is printed
+ */
+static int script_compile(const struct reg_registry *rr, const char *path, struct script *sc) {
+	char line[SCRIPT_LINE], *argv[8], *save;
+	const char *why = NULL;
+	int lineno = 0, argc;
+	FILE *f;
+
+	if(strcmp(path, "-") == 0)
+		f = stdin;
+	else if((f = fopen(path, "r")) == NULL) {
+		fprintf(stderr, "devicedbg: %s: %s\n", path, strerror(errno));
+		return -1;
+	}
+
+	while(why == NULL && fgets(line, sizeof(line), f) != NULL) {
+		lineno++;
+		line[strcspn(line, "#")] = '\0';
+
+		for(argc = 0, argv[0] = strtok_r(line, " \t\r\n", &save); argv[argc] != NULL &&
+		    argc < (int) ARRAY_SIZE(char *, argv) - 1; argv[++argc] = strtok_r(NULL, " \t\r\n", &save))
+			;
+		if(argc > 0)
+			why = script_statement(rr, sc, argv, argc, lineno);
+	}
+
+	if(f != stdin)
+		fclose(f);
+
+	if(why != NULL) {
+		fprintf(stderr, "devicedbg: %s:%d: %s\n", path, lineno, why);
+		return -1;
+	}
+	return 0;
+}
+
+/* Waits until a time of the monotonic clock, sleeping then spinning */
+static void script_wait(uint64_t until) {
+	struct timespec ts;
+	uint64_t now = now_ns();
+
+	if(until > now + SCRIPT_SPIN_NS) {
+		until -= SCRIPT_SPIN_NS;
+		ts.tv_sec = until / 1000000000ULL;
+		ts.tv_nsec = until % 1000000000ULL;
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+		until += SCRIPT_SPIN_NS;
+	}
+
+	while(now_ns() < until)
+		;
+}
+
+/*
+ * Executes a compiled script
+ * Output:
+ *	number of steps run to completion; the step it stopped at, if any,
+ *	is in *failed with 1 for a failed poll or assert, 2 for a bus error
+ */
+static int script_run(const struct reg_registry *rr, struct script *sc, int *failed) {
+	const uint32_t *code = sc->code;
+	volatile uint32_t *r;
+	struct script_step *st;
+	sigjmp_buf env, *prev;
+	volatile int s = 0;
+	uint64_t t, deadline;
+	uint32_t v, w;
+	int pc;
+
+	*failed = 0;
+
+	// a bus error comes back here and ends the script
+	prev = mem_guard(&env);
+	if(sigsetjmp(env, 0) != 0) {
+		w = code[sc->steps[s].pc] >> 8;
+		if(sc->entry[w] >= 0)
+			avail_mark(rr, sc->entry[w]);
+		*failed = 2;
+		mem_guard(prev);
+		return s;
+	}
+
+	for(; s < sc->num_steps; s++) {
+		st = &sc->steps[s];
+		pc = st->pc;
+		w = code[pc];
+		r = sc->virt[w >> 8];
+		t = now_ns();
+
+		switch(w & 0xFF) {
+			case SC_READ:
+				st->value = (*r & code[pc + 1]) >> code[pc + 2];
+				break;
+			case SC_WRITE:
+				*r = st->value = code[pc + 1];
+				break;
+			case SC_RMW:
+				*r = st->value = (*r & ~code[pc + 1]) | code[pc + 2];
+				break;
+			case SC_POLL:
+				deadline = t + code[pc + 3] * 1000ULL;
+				do {
+					v = *r;
+					st->polls++;
+				} while((v & code[pc + 1]) != code[pc + 2] && now_ns() < deadline);
+				st->value = v;
+				*failed = (v & code[pc + 1]) != code[pc + 2];
+				break;
+			case SC_DELAY:
+				script_wait(t + code[pc + 1] * 1000ULL);
+				break;
+			case SC_ASSERT:
+				st->value = *r;
+				*failed = (st->value & code[pc + 1]) != code[pc + 2];
+				break;
+		}
+
+		st->ns = now_ns() - t;
+		if(*failed)
+			break;
+	}
+
+	mem_guard(prev);
+	return s;
+}
+
+/* Prints one step of the trace */
+static void script_print(const struct reg_registry *rr, const struct script *sc,
+			 const struct script_step *st, int failed) {
+	const uint32_t *insn = sc->code + st->pc;
+	int op = insn[0] & 0xFF, slot = insn[0] >> 8;
+	char qname[REG_NAME_LEN];
+	const char *name = "";
+
+	if(op == SC_DELAY) {
+		printf("%4d %-6s %-32s %23s %10.1f us\n", st->line, st->what, "", "", st->ns / 1e3);
+		return;
+	}
+
+	if(sc->entry[slot] >= 0)
+		name = reg_entry_name(&rr->entries[sc->entry[slot]], qname);
+	printf("%4d %-6s %-32s 0x%08lX: 0x%08X %10.1f us", st->line, st->what, name,
+	       sc->addr[slot], st->value, st->ns / 1e3);
+
+	if(op == SC_POLL)
+		printf(", %u reads", st->polls);
+	if(failed)
+		printf(op == SC_POLL ? ", TIMEOUT waiting for 0x%08X under 0x%08X" :
+		       ", FAILED expected 0x%08X under 0x%08X", insn[2], insn[1]);
+	if(sc->entry[slot] >= 0 && (op != SC_READ || insn[1] == ~0U))
+		printf("%s", reg_decode_cached(rr->entries[sc->entry[slot]].reg, st->value));
+	printf("\n");
+}
+
+/*
+ * Compiles and runs a register script
+ * Input:
+ *	const struct reg_registry *rr	- registry of the detected family
+ *	const char *path		- script file, "-" for the standard input
+ *
+ * Output:
+ *	exit status of the program: 0 if the script ran to its end, 2 if a
+ *	poll timed out or an assert failed, 1 on error
+ */
+int run_script(const struct reg_registry *rr, const char *path) {
+	struct script sc;
+	uint64_t compile, elapsed;
+	int done, failed, i;
+
+	memset(&sc, 0, sizeof(sc));
+
+	compile = now_ns();
+	if(script_compile(rr, path, &sc) == -1) {
+		script_free(&sc);
+		return 1;
+	}
+	compile = now_ns() - compile;
+
+	elapsed = now_ns();
+	done = script_run(rr, &sc, &failed);
+	elapsed = now_ns() - elapsed;
+
+	for(i = 0; i < done + (failed == 1); i++)
+		script_print(rr, &sc, &sc.steps[i], failed == 1 && i == done);
+
+	if(failed == 2)
+		printf("bus error at line %d, module not available\n", sc.steps[done].line);
+	printf("%s: %d of %d steps in %.1f us, %d bytes of bytecode on %d registers compiled in %.1f us\n",
+	       failed ? "FAIL" : "OK", done + (failed == 1), sc.num_steps, elapsed / 1e3,
+	       sc.len * (int) sizeof(uint32_t), sc.num_regs, compile / 1e3);
+
+	script_free(&sc);
+	return failed == 2 ? 1 : failed ? 2 : 0;
+}
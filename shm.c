@@ -0,0 +1,211 @@
+/*
+ * shm.c : latest full snapshot published in POSIX shared memory
+ *
+ * One sampler reads every register of the registry at a fixed interval and
+ * publishes the values into a shared memory segment, laid out in registry
+ * order behind a small header. The segment is guarded by a seqlock: the
+ * writer makes the sequence odd while it copies the values and even again
+ * once done, readers copy the values and retry when the sequence was odd or
+ * moved meanwhile. Readers never make a system call nor touch the hardware,
+ * and any number of them can run against one sampler.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "devicedbg.h"
+
+static volatile sig_atomic_t sampler_quit;
+
+static void sampler_signal(int sig) {
+	sampler_quit = 1;
+}
+
+static size_t shm_size(uint32_t count) {
+	return sizeof(struct dd_shm) + count * sizeof(uint32_t);
+}
+
+/* Writer side of the seqlock */
+void shm_publish(struct dd_shm *shm, const uint32_t *values) {
+	uint32_t seq = shm->seq;
+
+	__atomic_store_n(&shm->seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	memcpy(shm->values, values, shm->count * sizeof(uint32_t));
+	shm->samples++;
+	shm->timestamp_ns = now_ns();
+
+	__atomic_store_n(&shm->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/*
+ * Reader side of the seqlock: copies a consistent snapshot
+ * Input:
+ *	const struct dd_shm *shm	- mapped segment
+ *	uint32_t *values		- receives shm->count values
+ *
+ * Output:
+ *	sample number of the copied snapshot
+ */
+uint64_t shm_snapshot(const struct dd_shm *shm, uint32_t *values) {
+	uint32_t seq;
+	uint64_t samples;
+
+	for(;;) {
+		seq = __atomic_load_n(&shm->seq, __ATOMIC_ACQUIRE);
+		if(seq & 1)
+			continue;
+
+		memcpy(values, (const void *) shm->values, shm->count * sizeof(uint32_t));
+		samples = shm->samples;
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if(__atomic_load_n(&shm->seq, __ATOMIC_RELAXED) == seq)
+			return samples;
+	}
+}
+
+/* Maps an existing segment read-only
+ * Output:
+ *	segment or NULL with errno set
+ */
+const struct dd_shm *shm_attach(const char *name) {
+	struct dd_shm *shm;
+	struct stat st;
+	int fd;
+
+	if((fd = shm_open(name, O_RDONLY, 0)) == -1)
+		return NULL;
+
+	if(fstat(fd, &st) == -1 || st.st_size < sizeof(struct dd_shm)) {
+		close(fd);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	shm = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(shm == (void *) -1)
+		return NULL;
+
+	if(shm->magic != DD_SHM_MAGIC || shm->version != DD_SHM_VERSION ||
+	   st.st_size < shm_size(shm->count)) {
+		munmap(shm, st.st_size);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	return shm;
+}
+
+/*
+ * Publishes the snapshot of every register until SIGINT or SIGTERM
+ * Input:
+ *	const char *name		- shared memory object name, e.g. "/devicedbg"
+ *	const struct reg_registry *rr	- registry of the detected family
+ *	int interval_ms			- sampling period
+ *
+ * Output:
+ *	exit status of the program
+ */
+int run_publisher(const char *name, const struct reg_registry *rr, int interval_ms) {
+	struct read_plan plan;
+	struct sigaction sa;
+	struct timespec next;
+	struct dd_shm *shm;
+	uint32_t *values;
+	int fd;
+
+	if((fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, 0644)) == -1) FATAL;
+	if(ftruncate(fd, shm_size(rr->count)) == -1) FATAL;
+
+	shm = mmap(0, shm_size(rr->count), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if(shm == (void *) -1) FATAL;
+	close(fd);
+
+	shm->version = DD_SHM_VERSION;
+	shm->type = rr->family->type;
+	shm->hash = rr->hash;
+	shm->count = rr->count;
+	shm->interval_ms = interval_ms;
+	__atomic_store_n(&shm->magic, DD_SHM_MAGIC, __ATOMIC_RELEASE);
+
+	if((values = malloc(rr->count * sizeof(uint32_t))) == NULL) FATAL;
+	if(plan_build_all(&plan, rr) == -1) FATAL;
+
+	printf("publishing %d registers every %d ms in %s\n", rr->count, interval_ms, name);
+	fflush(stdout);
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = sampler_signal;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	while(!sampler_quit) {
+		plan_run(&plan, values);
+		shm_publish(shm, values);
+
+		next.tv_nsec += interval_ms * 1000000L;
+		next.tv_sec += next.tv_nsec / 1000000000L;
+		next.tv_nsec %= 1000000000L;
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+	}
+
+	shm_unlink(name);
+	munmap(shm, shm_size(rr->count));
+	plan_free(&plan);
+	free(values);
+
+	return 0;
+}
+
+/*
+ * Prints the latest snapshot published by a sampler
+ * Input:
+ *	const char *name - shared memory object name
+ *
+ * Output:
+ *	exit status of the program
+ */
+int run_shm_reader(const char *name) {
+	const struct soc_family *family;
+	const struct dd_shm *shm;
+	struct reg_registry rr;
+	uint32_t *values;
+	char qname[REG_NAME_LEN];
+	uint64_t sample;
+	int i;
+
+	if((shm = shm_attach(name)) == NULL) {
+		fprintf(stderr, "devicedbg: cannot attach %s: %s\n", name, strerror(errno));
+		return 1;
+	}
+
+	if((family = find_family_type(shm->type)) == NULL ||
+	   registry_build(&rr, family) == -1 || rr.hash != shm->hash) {
+		fprintf(stderr, "devicedbg: %s does not match the register tables\n", name);
+		return 1;
+	}
+
+	if((values = malloc(rr.count * sizeof(uint32_t))) == NULL) FATAL;
+
+	sample = shm_snapshot(shm, values);
+	printf("sample %llu\n", (unsigned long long) sample);
+	for(i = 0; i < rr.count; i++)
+		printf("%-32s 0x%08lX: 0x%08X\n", reg_entry_name(&rr.entries[i], qname),
+		       rr.entries[i].addr, values[i]);
+
+	free(values);
+	registry_free(&rr);
+	return 0;
+}
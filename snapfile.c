@@ -0,0 +1,151 @@
+/*
+ * snapfile.c : snapshot files, a header followed by fixed size records
+ *
+ * A file holds the snapshots of one agent, appended as they come. The header
+ * records the processor type and the registry hash, so a file is only ever
+ * extended with snapshots of the same register layout and readers know which
+ * tables decode it. The layout is described with struct dd_snap_hdr.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <endian.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+
+#include "devicedbg.h"
+
+/*
+ * Opens a snapshot file for appending, creating it if needed
+ * Input:
+ *	const char *path	- file name
+ *	int type		- processor type of the snapshots
+ *	uint32_t hash, count	- registry hash and number of registers
+ *	const char *source	- where the snapshots come from, informative
+ *
+ * Output:
+ *	file descriptor or -1 with errno set, EINVAL if the file holds
+ *	snapshots of another layout
+ */
+int snap_open(const char *path, int type, uint32_t hash, uint32_t count, const char *source) {
+	struct dd_snap_hdr hdr, old;
+	struct stat st;
+	int fd, err;
+
+	if((fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644)) == -1)
+		return -1;
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = htole32(DD_SNAP_MAGIC);
+	hdr.version = htole16(DD_SNAP_VERSION);
+	hdr.type = htole16(type);
+	hdr.hash = htole32(hash);
+	hdr.count = htole32(count);
+	strncpy(hdr.source, source, sizeof(hdr.source) - 1);
+
+	if(fstat(fd, &st) == -1)
+		goto fail;
+
+	if(st.st_size == 0) {
+		if(write(fd, &hdr, sizeof(hdr)) != sizeof(hdr))
+			goto fail;
+		return fd;
+	}
+
+	if(pread(fd, &old, sizeof(old), 0) != sizeof(old) || old.magic != hdr.magic ||
+	   old.version != hdr.version || old.type != hdr.type || old.hash != hdr.hash ||
+	   old.count != hdr.count) {
+		errno = EINVAL;
+		goto fail;
+	}
+
+	// drop a record cut short by a crash, records stay at fixed offsets
+	if((st.st_size - sizeof(hdr)) % DD_SNAP_RECORD(count) != 0 &&
+	   ftruncate(fd, st.st_size - (st.st_size - sizeof(hdr)) % DD_SNAP_RECORD(count)) == -1)
+		goto fail;
+
+	return fd;
+
+fail:
+	err = errno;
+	close(fd);
+	errno = err;
+	return -1;
+}
+
+/* Appends one record, values are little endian as received from the daemon
+ * Output:
+ *	0 on success, -1 with errno set
+ */
+int snap_append(int fd, uint64_t time_ns, const void *values, uint32_t count) {
+	struct iovec iov[2];
+	uint64_t t = htole64(time_ns);
+	ssize_t n;
+
+	iov[0].iov_base = &t;
+	iov[0].iov_len = sizeof(t);
+	iov[1].iov_base = (void *) values;
+	iov[1].iov_len = 4 * (size_t) count;
+
+	if((n = writev(fd, iov, 2)) != DD_SNAP_RECORD(count)) {
+		if(n >= 0)
+			errno = ENOSPC;
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Maps a snapshot file read-only
+ * Input:
+ *	const char *path	- file name
+ *	size_t *size		- receives the mapping size
+ *
+ * Output:
+ *	header or NULL with errno set, EINVAL if it is not a snapshot file
+ */
+const struct dd_snap_hdr *snap_map(const char *path, size_t *size) {
+	const struct dd_snap_hdr *hdr;
+	struct stat st;
+	int fd;
+
+	if((fd = open(path, O_RDONLY | O_CLOEXEC)) == -1)
+		return NULL;
+
+	if(fstat(fd, &st) == -1 || st.st_size < sizeof(*hdr)) {
+		close(fd);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	hdr = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(hdr == (void *) -1)
+		return NULL;
+
+	if(le32toh(hdr->magic) != DD_SNAP_MAGIC || le16toh(hdr->version) != DD_SNAP_VERSION) {
+		munmap((void *) hdr, st.st_size);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	*size = st.st_size;
+	return hdr;
+}
+
+/* Number of complete records of a mapped file */
+size_t snap_records(const struct dd_snap_hdr *hdr, size_t size) {
+	return (size - sizeof(*hdr)) / DD_SNAP_RECORD(le32toh(hdr->count));
+}
+
+/* Values of the i-th record of a mapped file, little endian */
+const uint8_t *snap_values(const struct dd_snap_hdr *hdr, size_t i) {
+	return (const uint8_t *) (hdr + 1) + i * DD_SNAP_RECORD(le32toh(hdr->count)) + 8;
+}
@@ -0,0 +1,208 @@
+/*
+ * soc.c : SoC family registry and processor identification
+ *
+ * The registry itself only holds what is needed for detection. The register
+ * tables of a family are reached through family_tables(), which returns the
+ * built-in soc_family.tables unless a description file was loaded for the
+ * family (see desc.c); they are not dereferenced before the family has been
+ * detected.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "devicedbg.h"
+
+// ID_CODE[31:28] is the silicon revision, it is not part of the match
+static const struct soc_variant omap44x_variants[] = {
+	{ OMAP4430_HAWKEYE_NUM1, "OMAP4430" },
+	{ OMAP4460_RAMP_SYSTEM,  "OMAP4460" },
+	{ OMAP4430_HAWKEYE_NUM2, "OMAP4430" },
+	{ OMAP4470_RAMP_SYSTEM,  "OMAP4470" }
+};
+
+static const struct soc_variant am335x_variants[] = {
+	{ AM3357_DEVICE_ID, "AM3357" },
+	{ AM3352_DEVICE_ID, "AM3352" },
+	{ AM3356_DEVICE_ID, "AM3356" },
+	{ AM3359_DEVICE_ID, "AM3359" },
+	{ AM3354_DEVICE_ID, "AM3354" },
+	{ AM3358_DEVICE_ID, "AM3358" }
+};
+
+static const struct soc_variant omap35x_variants[] = {
+	{ OMAP3530_CHIP_ID, "OMAP3530" },
+	{ OMAP3515_CHIP_ID, "OMAP3515" },
+	{ OMAP3525_CHIP_ID, "OMAP3525" },
+	{ OMAP3503_CHIP_ID, "OMAP3503" }
+};
+
+const struct soc_family soc_families[] = {
+	{ OMAP4, "OMAP4", "OMAP44x", "OMAP4",
+	  0x4A002000, 0x204, "ID_CODE", 0x0FFFFFFF, 4,
+	  omap44x_variants, ARRAY_SIZE(struct soc_variant, omap44x_variants),
+	  &omap44x_tables },
+	{ AM335x, "AM335x", "AM335x", "am335",
+	  0x44E10600, 0x04, "DEVICE_FEATURE", 0xFFFFFFFF, 0,
+	  am335x_variants, ARRAY_SIZE(struct soc_variant, am335x_variants),
+	  &am335x_tables },
+	{ OMAP35x, "OMAP35x", "OMAP35x", "OMAP35",
+	  0x48002400, 0x4C, "CHIP_ID", 0xFFFFFFFF, 0,
+	  omap35x_variants, ARRAY_SIZE(struct soc_variant, omap35x_variants),
+	  &omap35x_tables }
+};
+
+const int num_soc_families = ARRAY_SIZE(struct soc_family, soc_families);
+
+const char *const section_names[NUM_SECTIONS] = {
+	"DCAN", "GPIO", "I2C", "LCD_CONTROLLER", "MCASP/MCBSP", "MCSPI", "MMCSD",
+	"RTC", "TIMER", "TSC", "UART", "USB", "WDT", "PRODUCT_ID", "LCD"
+};
+
+/* tables loaded from description files, by family */
+static const struct soc_tables *loaded_tables[ARRAY_SIZE(struct soc_family, soc_families)];
+
+/* Register tables of a family, a loaded description or the built-in ones */
+const struct soc_tables *family_tables(const struct soc_family *family) {
+	const struct soc_tables *tables = loaded_tables[family - soc_families];
+
+	return tables != NULL ? tables : family->tables;
+}
+
+/* Replaces the built-in tables of a family for the rest of the run */
+void family_set_tables(const struct soc_family *family, const struct soc_tables *tables) {
+	loaded_tables[family - soc_families] = tables;
+}
+
+
+static int soc_variant_cmp(const void *key, const void *elem) {
+	unsigned long id = *(const unsigned long *) key;
+	const struct soc_variant *v = elem;
+
+	if(id < v->id)
+		return -1;
+	return id > v->id;
+}
+
+/* Looks up the family member for a normalized identification value
+ * Output:
+ *	variant entry or NULL if the value is not known for the family
+ */
+const struct soc_variant *find_soc_variant(const struct soc_family *family, unsigned long id) {
+	return bsearch(&id, family->variants, family->num_variants,
+		       sizeof(struct soc_variant), soc_variant_cmp);
+}
+
+/* Identifies the family member by reading its identification register
+ * Input:
+ *	const struct soc_family *family - family matched from /proc/cpuinfo
+ *
+ * Output:
+ *	member name is shown
+ */
+void identify_soc(const struct soc_family *family) {
+	char name[REG_NAME_LEN + 1] = "";	/* front-coded, shares nothing */
+	struct reg_info id_reg = { family->id_offset, name };
+	const struct soc_variant *variant;
+	unsigned long id_value;
+	uint32_t raw;
+
+	printf("%s Processor\n", family->name);
+
+	snprintf(name + 1, REG_NAME_LEN, "%s", family->id_reg_name);
+
+	show_registers(&id_reg, 1, family->id_base, &raw);
+	id_value = (raw & family->id_mask) << family->id_shift;
+	printf("id_value :: %lX\n", id_value);
+
+	variant = find_soc_variant(family, id_value);
+	if(variant != NULL)
+		printf("It is %s\n", variant->name);
+	else
+		printf("It does not belong to %s Family\n", family->series);
+}
+
+/* Reads the /proc/cpuinfo and finds out which processor we are working on
+ * Input:
+ *	No input required
+ *
+ * Output:
+ *	matching entry of soc_families[] or NULL
+ */
+const struct soc_family *read_processor(void) {
+	FILE *fp = fopen(CPUINFO_FILE,"r");
+	char field[30];
+	int i;
+
+	if(fp == NULL) {
+		fprintf(stderr,"Cannot open the cpuinfo file for reading\n");
+		exit(1);
+	}
+
+	while(fscanf(fp,"%s",field) != EOF) {
+		if(strcmp(field,"Hardware") == 0) {
+			// seek past three characters to get the "Hardware" field's value
+			fseek(fp,3,SEEK_CUR);
+			fgets(field,sizeof(field),fp);
+			printf("%s",field);
+
+			for(i = 0; i < num_soc_families; i++) {
+				if(strstr(field, soc_families[i].cpuinfo_match) != NULL) {
+					fclose(fp);
+					identify_soc(&soc_families[i]);
+					return &soc_families[i];
+				}
+			}
+
+			break;
+		}
+
+		fgets(field,sizeof(field),fp);
+	}
+
+	// not able to recognize the processor
+	fclose(fp);
+	return NULL;
+}
+
+/* Finds the register section of a detected family
+ * Output:
+ *	section or NULL if the family does not have it
+ */
+const struct reg_section *find_section(const struct soc_family *family, int id) {
+	const struct soc_tables *tables = family_tables(family);
+	int i;
+
+	for(i = 0; i < tables->num_sections; i++) {
+		if(tables->sections[i].id == id)
+			return &tables->sections[i];
+	}
+
+	return NULL;
+}
+
+/* Finds a family by name (case insensitive), used to skip the detection */
+const struct soc_family *find_family(const char *name) {
+	int i;
+
+	for(i = 0; i < num_soc_families; i++) {
+		if(strcasecmp(soc_families[i].name, name) == 0)
+			return &soc_families[i];
+	}
+
+	return NULL;
+}
+
+/* Finds a family by processor type */
+const struct soc_family *find_family_type(int type) {
+	int i;
+
+	for(i = 0; i < num_soc_families; i++) {
+		if(soc_families[i].type == type)
+			return &soc_families[i];
+	}
+
+	return NULL;
+}
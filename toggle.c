@@ -0,0 +1,254 @@
+/*
+ * toggle.c : per-bit toggle statistics of a capture
+ *
+ * Chasing an intermittent fault needs to know which bits ever flipped and how
+ * often, not every sample. The aggregator keeps, for every register, the
+ * first, last, lowest and highest value, the number of samples in which it
+ * changed, the bits that ever flipped and one toggle counter per bit, all
+ * updated from the XOR of each new sample with the previous one. Its memory
+ * is fixed by the number of registers, whatever the length of the capture.
+ *
+ * The registers are processed four at a time (dd_v4). The per-bit counters are
+ * stored bit-major, counters[bit][register], so that one vector addition
+ * updates a bit of four registers; they are 32 bit wide and folded into the
+ * 64 bit totals before they could wrap. Groups of four registers that did not
+ * change are skipped after the XOR.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+
+#include "devicedbg.h"
+
+struct toggle_stats {
+	int n;				/* registers */
+	int nv;				/* dd_v4 per array, n rounded up */
+	uint64_t samples;
+	uint32_t pending;		/* samples since the counters were folded */
+	dd_v4 *first, *last, *min, *max;
+	dd_v4 *flipped;			/* bits that flipped at least once */
+	dd_v4 *changes;			/* samples with a change, folded like counters */
+	dd_v4 *counters;		/* [32][nv], toggles since the last fold */
+	uint64_t *totals;		/* [33][4 * nv], folded counters then changes */
+};
+
+static volatile sig_atomic_t toggle_quit, toggle_report;
+
+static void toggle_signal(int sig) {
+	if(sig == SIGUSR1)
+		toggle_report = 1;
+	else
+		toggle_quit = 1;
+}
+
+static dd_v4 *toggle_alloc(size_t nv) {
+	void *p;
+
+	if(posix_memalign(&p, sizeof(dd_v4), nv * sizeof(dd_v4)) != 0) FATAL;
+	memset(p, 0, nv * sizeof(dd_v4));
+	return p;
+}
+
+static void toggle_init(struct toggle_stats *ts, int n) {
+	memset(ts, 0, sizeof(*ts));
+	ts->n = n;
+	ts->nv = (n + 3) / 4;
+
+	ts->first = toggle_alloc(ts->nv);
+	ts->last = toggle_alloc(ts->nv);
+	ts->min = toggle_alloc(ts->nv);
+	ts->max = toggle_alloc(ts->nv);
+	ts->flipped = toggle_alloc(ts->nv);
+	ts->changes = toggle_alloc(ts->nv);
+	ts->counters = toggle_alloc(32 * (size_t) ts->nv);
+	if((ts->totals = calloc(33 * 4 * (size_t) ts->nv, sizeof(uint64_t))) == NULL) FATAL;
+}
+
+static void toggle_free(struct toggle_stats *ts) {
+	free(ts->first);
+	free(ts->last);
+	free(ts->min);
+	free(ts->max);
+	free(ts->flipped);
+	free(ts->changes);
+	free(ts->counters);
+	free(ts->totals);
+}
+
+/* Moves the 32 bit counters into the totals */
+static void toggle_fold(struct toggle_stats *ts) {
+	const uint32_t *c = (const uint32_t *) ts->counters;
+	const uint32_t *ch = (const uint32_t *) ts->changes;
+	size_t i, size = 32 * 4 * (size_t) ts->nv;
+
+	for(i = 0; i < size; i++)
+		ts->totals[i] += c[i];
+	for(i = 0; i < 4 * (size_t) ts->nv; i++)
+		ts->totals[size + i] += ch[i];
+
+	memset(ts->counters, 0, 32 * ts->nv * sizeof(dd_v4));
+	memset(ts->changes, 0, ts->nv * sizeof(dd_v4));
+	ts->pending = 0;
+}
+
+/*
+ * Adds one sample to the statistics
+ * Input:
+ *	struct toggle_stats *ts	- aggregator
+ *	const dd_v4 *v		- values of the registers, padded to a whole dd_v4
+ */
+static void toggle_add(struct toggle_stats *ts, const dd_v4 *v) {
+	const dd_v4 one = { 1, 1, 1, 1 };
+	dd_v4 x, m, *c;
+	int i, b;
+
+	if(ts->samples++ == 0) {
+		memcpy(ts->first, v, ts->nv * sizeof(dd_v4));
+		memcpy(ts->last, v, ts->nv * sizeof(dd_v4));
+		memcpy(ts->min, v, ts->nv * sizeof(dd_v4));
+		memcpy(ts->max, v, ts->nv * sizeof(dd_v4));
+		return;
+	}
+
+	if(ts->pending == UINT32_MAX)
+		toggle_fold(ts);
+	ts->pending++;
+
+	for(i = 0; i < ts->nv; i++) {
+		x = v[i] ^ ts->last[i];
+		if((x[0] | x[1] | x[2] | x[3]) == 0)
+			continue;
+
+		ts->last[i] = v[i];
+		ts->flipped[i] |= x;
+		ts->changes[i] += (dd_v4) (x != 0) & one;
+
+		m = (dd_v4) (v[i] < ts->min[i]);
+		ts->min[i] = (v[i] & m) | (ts->min[i] & ~m);
+		m = (dd_v4) (v[i] > ts->max[i]);
+		ts->max[i] = (v[i] & m) | (ts->max[i] & ~m);
+
+		for(b = 0, c = ts->counters + i; b < 32; b++, c += ts->nv)
+			*c += (x >> b) & one;
+	}
+}
+
+/* Prints the registers that changed, with the toggle count of every bit that flipped */
+static void toggle_print(const struct toggle_stats *ts, const struct reg_registry *rr,
+			 const int *indices, uint64_t elapsed, uint64_t overruns) {
+	const uint32_t *first = (const uint32_t *) ts->first, *last = (const uint32_t *) ts->last;
+	const uint32_t *min = (const uint32_t *) ts->min, *max = (const uint32_t *) ts->max;
+	const uint32_t *flipped = (const uint32_t *) ts->flipped;
+	const uint32_t *counters = (const uint32_t *) ts->counters;
+	const uint32_t *changes = (const uint32_t *) ts->changes;
+	size_t stride = 4 * (size_t) ts->nv;
+	char qname[REG_NAME_LEN];
+	uint64_t hits, misses;
+	int i, b, changed = 0;
+
+	printf("%llu samples of %d registers in %.1f s, %llu overruns\n",
+	       (unsigned long long) ts->samples, ts->n, elapsed / 1e9,
+	       (unsigned long long) overruns);
+
+	for(i = 0; i < ts->n; i++) {
+		if(flipped[i] == 0)
+			continue;
+		changed++;
+
+		printf("%-32s first 0x%08X last 0x%08X min 0x%08X max 0x%08X, %llu changes, "
+		       "%d bits flipped%s\n", reg_entry_name(&rr->entries[indices[i]], qname),
+		       first[i], last[i], min[i], max[i],
+		       (unsigned long long) (ts->totals[32 * stride + i] + changes[i]),
+		       __builtin_popcount(flipped[i]),
+		       reg_decode_cached(rr->entries[indices[i]].reg, last[i]));
+
+		for(b = 31; b >= 0; b--) {
+			if(flipped[i] & (1U << b))
+				printf("\tbit %2d: %llu toggles\n", b, (unsigned long long)
+				       (ts->totals[b * stride + i] + counters[b * stride + i]));
+		}
+	}
+
+	reg_decode_stats(&hits, &misses);
+	printf("%d of %d registers changed, decode cache %llu hits %llu misses\n", changed, ts->n,
+	       (unsigned long long) hits, (unsigned long long) misses);
+	fflush(stdout);
+}
+
+/*
+ * Samples registers until SIGINT or SIGTERM and prints their toggle
+ * statistics, SIGUSR1 prints them meanwhile
+ * Input:
+ *	const struct reg_registry *rr	- registry of the detected family
+ *	int interval_ms			- sampling period
+ *	int argc, char **argv		- register patterns, all the registers if none
+ *
+ * Output:
+ *	exit status of the program
+ */
+int run_toggle_capture(const struct reg_registry *rr, int interval_ms, int argc, char **argv) {
+	struct toggle_stats ts;
+	struct read_plan plan;
+	struct sigaction sa;
+	struct timespec next;
+	uint64_t start, now, overruns = 0;
+	dd_v4 *values;
+	int *indices, n;
+
+	if((indices = malloc(rr->count * sizeof(int))) == NULL) FATAL;
+	if((n = registry_select(rr, argc, argv, indices)) == 0) {
+		free(indices);
+		return 1;
+	}
+
+	if(plan_build(&plan, rr, indices, n) == -1) FATAL;
+	toggle_init(&ts, n);
+	values = toggle_alloc(ts.nv);
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = toggle_signal;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+	sigaction(SIGUSR1, &sa, NULL);
+
+	printf("capturing %d registers every %d ms, SIGUSR1 prints the statistics\n",
+	       n, interval_ms);
+	fflush(stdout);
+
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	start = now_ns();
+	while(!toggle_quit) {
+		plan_run(&plan, (uint32_t *) values);
+		toggle_add(&ts, values);
+
+		if(toggle_report) {
+			toggle_report = 0;
+			toggle_print(&ts, rr, indices, now_ns() - start, overruns);
+		}
+
+		next.tv_nsec += interval_ms * 1000000L;
+		next.tv_sec += next.tv_nsec / 1000000000L;
+		next.tv_nsec %= 1000000000L;
+
+		// a late sample is counted, the schedule restarts from now
+		now = now_ns();
+		if(now > next.tv_sec * 1000000000ULL + next.tv_nsec) {
+			overruns++;
+			clock_gettime(CLOCK_MONOTONIC, &next);
+			continue;
+		}
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+	}
+
+	toggle_print(&ts, rr, indices, now_ns() - start, overruns);
+
+	toggle_free(&ts);
+	plan_free(&plan);
+	free(values);
+	free(indices);
+	return 0;
+}
@@ -0,0 +1,329 @@
+/*
+ * write.c : batches of register writes
+ *
+ * A batch is a list of operations, given on the command line or read from
+ * the standard input one per line ('#' starts a comment):
+ *
+ *	write UART1.MDR1 0x7		the whole register
+ *	set TIMER2.TCLR 0x1		OR of bits, read-modify-write
+ *	clear TIMER2.TCLR 0x1		AND NOT of bits, read-modify-write
+ *	field UART1.LCR:CHAR_LENGTH 8BITS  one field, by value or value name
+ *	verify UART1.DLL 0x1A		write, read back and compare
+ *	barrier				the writes before reach their modules
+ *
+ * Registers are "INSTANCE.REGISTER" names or physical addresses. The whole
+ * batch is checked before the first write: the registers exist, their
+ * modules are clocked, and the operations that read the register do not
+ * touch one with side effects on read (see plan_readable()).
+ *
+ * The operations run in the given order, they are never sorted or merged as
+ * reads are, over the cached mappings of mem.c. Writes to the L4 modules are
+ * posted: a barrier orders the memory accesses and reads back the last
+ * register written, which returns once that write has completed. Every
+ * operation is timed, the latency includes its read and read back.
+ *
+ * A bus error stops the batch, the operations after it are not run.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+
+#include "devicedbg.h"
+
+#define WRITE_LINE	256
+
+enum { WRITE_WRITE, WRITE_SET, WRITE_CLEAR, WRITE_FIELD, WRITE_VERIFY, WRITE_BARRIER };
+
+static const char *const write_names[] = { "write", "set", "clear", "field", "verify", "barrier" };
+
+/* one operation of a batch */
+struct write_op {
+	int type;				/* WRITE_* */
+	int entry;				/* registry index, -1 for a barrier */
+	volatile uint32_t *virt;
+	uint32_t mask, value;			/* bits written and their value */
+	uint32_t before, after, check;		/* read, written, read back */
+	uint64_t ns;				/* latency */
+};
+
+/* operations being parsed, as words */
+struct write_words {
+	char **argv;
+	int argc, max;
+};
+
+static void write_add_word(struct write_words *w, const char *word) {
+	if(w->argc == w->max) {
+		w->max = w->max ? 2 * w->max : 64;
+		if((w->argv = realloc(w->argv, w->max * sizeof(char *))) == NULL) FATAL;
+	}
+	if((w->argv[w->argc++] = strdup(word)) == NULL) FATAL;
+}
+
+/* Reads the operations of the standard input */
+static void write_read_words(struct write_words *w) {
+	char line[WRITE_LINE], *word, *save;
+
+	while(fgets(line, sizeof(line), stdin) != NULL) {
+		line[strcspn(line, "#")] = '\0';
+		for(word = strtok_r(line, " \t\r\n", &save); word != NULL;
+		    word = strtok_r(NULL, " \t\r\n", &save))
+			write_add_word(w, word);
+	}
+}
+
+static int write_number(const char *arg, uint32_t *value) {
+	unsigned long v;
+	char *end;
+
+	errno = 0;
+	v = strtoul(arg, &end, 0);
+	if(errno != 0 || end == arg || *end != '\0' || v > UINT32_MAX)
+		return -1;
+
+	*value = v;
+	return 0;
+}
+
+/*
+ * Resolves the register of an operation, and its field for WRITE_FIELD
+ * Output:
+ *	0 on success, -1 on error, the reason is printed
+ */
+static int write_target(const struct reg_registry *rr, struct write_op *op, char *arg,
+			const char *value) {
+	const struct reg_field *f = NULL;
+	const struct reg_entry *e;
+	char *colon = NULL, qname[REG_NAME_LEN];
+
+	if(op->type == WRITE_FIELD && (colon = strrchr(arg, ':')) != NULL)
+		*colon = '\0';
+
+	if((op->entry = registry_lookup(rr, arg)) < 0) {
+		fprintf(stderr, "devicedbg: unknown register %s\n", arg);
+		return -1;
+	}
+	e = &rr->entries[op->entry];
+	reg_entry_name(e, qname);
+
+	if(op->type == WRITE_FIELD) {
+		if(colon == NULL || (f = reg_find_field(e->reg, colon + 1)) == NULL) {
+			fprintf(stderr, "devicedbg: %s has no field %s\n", qname, colon ? colon + 1 : "");
+			return -1;
+		}
+		if(reg_field_value(f, value, &op->value) == -1) {
+			fprintf(stderr, "devicedbg: %s:%s cannot take %s\n", qname, f->name, value);
+			return -1;
+		}
+		op->mask = reg_field_mask(f);
+	}
+	else if(write_number(value, &op->value) == -1) {
+		fprintf(stderr, "devicedbg: bad value %s for %s\n", value, qname);
+		return -1;
+	}
+
+	switch(op->type) {
+		case WRITE_SET:
+			op->mask = op->value;
+			break;
+		case WRITE_CLEAR:
+			op->mask = op->value;
+			op->value = 0;
+			break;
+		case WRITE_WRITE:
+		case WRITE_VERIFY:
+			op->mask = ~0U;
+			break;
+	}
+
+	// set, clear and field read the register first, verify reads it back
+	if((op->mask != ~0U || op->type == WRITE_VERIFY) && !plan_readable(e->reg)) {
+		fprintf(stderr, "devicedbg: %s cannot be read%s\n", qname,
+			e->reg->access == REG_WRITE_ONLY ? ", it is write-only" :
+			" without side effects, -X reads it");
+		return -1;
+	}
+
+	if(rr->absent[op->entry] || !avail_clocked(e->instance)) {
+		fprintf(stderr, "devicedbg: %s: module %s is not %s\n", qname, e->instance->name,
+			rr->absent[op->entry] ? "available" : "clocked");
+		return -1;
+	}
+
+	op->virt = mem_map(e->addr);
+	return 0;
+}
+
+/*
+ * Compiles the words of a batch into operations
+ * Output:
+ *	number of operations, -1 on error
+ */
+static int write_parse(const struct reg_registry *rr, int argc, char **argv, struct write_op *ops) {
+	int i = 0, n = 0, type;
+
+	while(i < argc) {
+		for(type = 0; type <= WRITE_BARRIER && strcasecmp(argv[i], write_names[type]) != 0; type++)
+			;
+		if(type > WRITE_BARRIER) {
+			fprintf(stderr, "devicedbg: unknown operation %s\n", argv[i]);
+			return -1;
+		}
+
+		memset(&ops[n], 0, sizeof(ops[n]));
+		ops[n].type = type;
+		ops[n].entry = -1;
+
+		if(type == WRITE_BARRIER) {
+			i++;
+			n++;
+			continue;
+		}
+
+		if(i + 2 >= argc) {
+			fprintf(stderr, "devicedbg: %s takes a register and a value\n", write_names[type]);
+			return -1;
+		}
+		if(write_target(rr, &ops[n], argv[i + 1], argv[i + 2]) == -1)
+			return -1;
+		i += 3;
+		n++;
+	}
+
+	return n;
+}
+
+/*
+ * Runs the operations of a batch in order
+ * Output:
+ *	number of operations run, the faulting one is not
+ */
+static int write_run(const struct reg_registry *rr, struct write_op *ops, int n) {
+	volatile uint32_t *last = NULL;
+	sigjmp_buf env, *prev;
+	struct write_op *op;
+	volatile int i = 0;
+	uint64_t t;
+
+	// a bus error comes back here and ends the batch
+	prev = mem_guard(&env);
+	if(sigsetjmp(env, 0) != 0) {
+		if(ops[i].entry >= 0)
+			avail_mark(rr, ops[i].entry);
+		mem_guard(prev);
+		return i;
+	}
+
+	for(; i < n; i++) {
+		op = &ops[i];
+		t = now_ns();
+
+		switch(op->type) {
+			case WRITE_BARRIER:
+				__sync_synchronize();
+				if(last != NULL)
+					(void) *last;
+				break;
+			default:
+				if(op->mask != ~0U)
+					op->before = *op->virt;
+				*op->virt = op->after = (op->before & ~op->mask) | op->value;
+				if(op->type == WRITE_VERIFY)
+					op->check = *op->virt;
+				break;
+		}
+
+		op->ns = now_ns() - t;
+
+		// the read back of a barrier only goes to registers that read safely
+		if(op->entry >= 0 && rr->entries[op->entry].reg->access == REG_READ_SAFE)
+			last = op->virt;
+	}
+
+	mem_guard(prev);
+	return n;
+}
+
+static void write_print(const struct reg_registry *rr, const struct write_op *op) {
+	char qname[REG_NAME_LEN];
+	const struct reg_entry *e;
+
+	if(op->type == WRITE_BARRIER) {
+		printf("%-7s %-32s %38s %8.2f us\n", "barrier", "", "", op->ns / 1e3);
+		return;
+	}
+
+	// read-modify-writes show the value before
+	e = &rr->entries[op->entry];
+	printf("%-7s %-32s 0x%08lX: ", write_names[op->type], reg_entry_name(e, qname), e->addr);
+	if(op->mask == ~0U)
+		printf("%14s0x%08X", "", op->after);
+	else
+		printf("0x%08X -> 0x%08X", op->before, op->after);
+	printf(" %8.2f us", op->ns / 1e3);
+
+	if(op->type == WRITE_VERIFY)
+		printf(", read back 0x%08X %s", op->check, op->check == op->after ? "ok" : "FAILED");
+	printf("%s\n", reg_decode_cached(e->reg, op->after));
+}
+
+/*
+ * Runs a batch of register writes
+ * Input:
+ *	const struct reg_registry *rr	- registry of the detected family
+ *	int argc, char **argv		- operations, read from the standard input if none
+ *
+ * Output:
+ *	exit status of the program: 0 if all the operations ran, 2 if one
+ *	verify failed, 1 on error
+ */
+int run_write(const struct reg_registry *rr, int argc, char **argv) {
+	struct write_words words = { NULL, 0, 0 };
+	char qname[REG_NAME_LEN];
+	struct write_op *ops;
+	uint64_t elapsed;
+	int n, i, done, failed = 0;
+
+	if(argc == 0) {
+		write_read_words(&words);
+		argc = words.argc;
+		argv = words.argv;
+	}
+
+	// at most one operation per word
+	if((ops = malloc((argc ? argc : 1) * sizeof(struct write_op))) == NULL) FATAL;
+
+	if((n = write_parse(rr, argc, argv, ops)) <= 0) {
+		if(n == 0)
+			fprintf(stderr, "devicedbg: no operation\n");
+		free(ops);
+		for(i = 0; i < words.argc; i++)
+			free(words.argv[i]);
+		free(words.argv);
+		return 1;
+	}
+
+	elapsed = now_ns();
+	done = write_run(rr, ops, n);
+	elapsed = now_ns() - elapsed;
+
+	for(i = 0; i < done; i++) {
+		write_print(rr, &ops[i]);
+		failed += ops[i].type == WRITE_VERIFY && ops[i].check != ops[i].after;
+	}
+
+	if(done < n)
+		printf("bus error at %s %s, %d operations not run\n", write_names[ops[done].type],
+		       ops[done].entry >= 0 ? reg_entry_name(&rr->entries[ops[done].entry], qname) : "",
+		       n - done);
+	printf("%d of %d operations in %.1f us, %d verify failed\n", done, n, elapsed / 1e3, failed);
+
+	free(ops);
+	for(i = 0; i < words.argc; i++)
+		free(words.argv[i]);
+	free(words.argv);
+	return done < n ? 1 : failed ? 2 : 0;
+}